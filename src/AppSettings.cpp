@@ -0,0 +1,110 @@
+#include "AppSettings.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSettings>
+#include <QStringList>
+#include <QTimer>
+
+AppSettings* AppSettings::instance() {
+    static AppSettings* settings = new AppSettings(qApp);
+    return settings;
+}
+
+AppSettings::AppSettings(QObject* parent)
+    : QObject(parent), m_values(read()), m_watcher(nullptr), m_reloadTimer(new QTimer(this)) {
+    // Editors and QSettings itself write in several steps; reload once they are done
+    m_reloadTimer->setSingleShot(true);
+    m_reloadTimer->setInterval(200);
+    connect(m_reloadTimer, &QTimer::timeout, this, &AppSettings::reload);
+}
+
+AppSettings::Values AppSettings::read() {
+    QSettings settings;
+    Values defaults;
+    Values values;
+    values.interval = settings.value("interval", defaults.interval).toInt();
+    values.dataOption = settings.value("dataOption", defaults.dataOption).toInt();
+    values.summaryThreshold = settings.value("summaryThreshold", defaults.summaryThreshold).toInt();
+    values.notificationDelayMs = settings.value("notificationDelayMs", defaults.notificationDelayMs).toInt();
+    values.trayUnreadLimit = settings.value("trayUnreadLimit", defaults.trayUnreadLimit).toInt();
+    values.hydrationPrefetchRows = settings.value("hydrationPrefetchRows", defaults.hydrationPrefetchRows).toInt();
+    values.avatarCacheMb = settings.value("avatarCacheMb", defaults.avatarCacheMb).toInt();
+    values.knownNotificationRetentionDays =
+        settings.value("knownNotificationRetentionDays", defaults.knownNotificationRetentionDays).toInt();
+    values.customSortKeys = settings.value("customSortKeys", defaults.customSortKeys).toString();
+    values.notifyOnce = settings.value("notifyOnce", defaults.notifyOnce).toBool();
+    values.notifyRead = settings.value("notifyRead", defaults.notifyRead).toBool();
+    return values;
+}
+
+void AppSettings::setValue(const QString& key, const QVariant& value) {
+    {
+        QSettings settings;
+        settings.setValue(key, value);
+    }
+    reload();
+}
+
+void AppSettings::reload() {
+    Values old = m_values;
+    m_values = read();
+
+    QStringList changed;
+    if (old.interval != m_values.interval) changed << "interval";
+    if (old.dataOption != m_values.dataOption) changed << "dataOption";
+    if (old.summaryThreshold != m_values.summaryThreshold) changed << "summaryThreshold";
+    if (old.notificationDelayMs != m_values.notificationDelayMs) changed << "notificationDelayMs";
+    if (old.trayUnreadLimit != m_values.trayUnreadLimit) changed << "trayUnreadLimit";
+    if (old.hydrationPrefetchRows != m_values.hydrationPrefetchRows) changed << "hydrationPrefetchRows";
+    if (old.avatarCacheMb != m_values.avatarCacheMb) changed << "avatarCacheMb";
+    if (old.knownNotificationRetentionDays != m_values.knownNotificationRetentionDays) {
+        changed << "knownNotificationRetentionDays";
+    }
+    if (old.customSortKeys != m_values.customSortKeys) changed << "customSortKeys";
+    if (old.notifyOnce != m_values.notifyOnce) changed << "notifyOnce";
+    if (old.notifyRead != m_values.notifyRead) changed << "notifyRead";
+
+    for (const QString& key : changed) {
+        emit valueChanged(key);
+    }
+}
+
+void AppSettings::setWatchFile(bool watch) {
+    if (watch == isWatchingFile()) return;
+
+    if (!watch) {
+        delete m_watcher;
+        m_watcher = nullptr;
+        m_reloadTimer->stop();
+        return;
+    }
+
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+        // Replacing the file (as most editors and QSettings do) drops it from the watch list
+        watchSettingsFile();
+        m_reloadTimer->start();
+    });
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        if (m_watcher->files().isEmpty()) {
+            watchSettingsFile();
+            m_reloadTimer->start();
+        }
+    });
+    watchSettingsFile();
+}
+
+void AppSettings::watchSettingsFile() {
+    QString path = QSettings().fileName();
+    if (!m_watcher->files().contains(path) && QFileInfo::exists(path)) {
+        m_watcher->addPath(path);
+    }
+    // The directory catches the file being created or replaced while it is not watched
+    QString dir = QFileInfo(path).absolutePath();
+    if (!m_watcher->directories().contains(dir) && QFileInfo::exists(dir)) {
+        m_watcher->addPath(dir);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef APPSETTINGS_H
+#define APPSETTINGS_H
+
+#include <QObject>
+#include <QString>
+#include <QVariant>
+
+class QFileSystemWatcher;
+class QTimer;
+
+// In-memory copy of the application's QSettings values, so hot paths read a member instead of opening the
+// settings file.
+//
+// Values are loaded once and reloaded after every write made through setValue() and, while watching is on,
+// whenever the settings file is changed by someone else. Each reload reports the keys whose value actually
+// changed. Only used from the GUI thread.
+class AppSettings : public QObject {
+    Q_OBJECT
+   public:
+    // How more pages are fetched once the first one is shown
+    enum GetDataOption { Manual, FillScreen, GetAll, Infinite };
+    Q_ENUM(GetDataOption)
+
+    static AppSettings* instance();
+
+    int interval() const { return m_values.interval; }
+    GetDataOption dataOption() const { return static_cast<GetDataOption>(m_values.dataOption); }
+    int summaryThreshold() const { return m_values.summaryThreshold; }
+    int notificationDelayMs() const { return m_values.notificationDelayMs; }
+    int trayUnreadLimit() const { return m_values.trayUnreadLimit; }
+    int hydrationPrefetchRows() const { return m_values.hydrationPrefetchRows; }
+    int avatarCacheMb() const { return m_values.avatarCacheMb; }
+    int knownNotificationRetentionDays() const { return m_values.knownNotificationRetentionDays; }
+    const QString& customSortKeys() const { return m_values.customSortKeys; }
+    bool notifyOnce() const { return m_values.notifyOnce; }
+    bool notifyRead() const { return m_values.notifyRead; }
+
+    void setValue(const QString& key, const QVariant& value);
+    void reload();
+
+    void setWatchFile(bool watch);
+    bool isWatchingFile() const { return m_watcher != nullptr; }
+
+   signals:
+    void valueChanged(const QString& key);
+
+   private:
+    explicit AppSettings(QObject* parent = nullptr);
+
+    struct Values {
+        int interval = 5;
+        int dataOption = 0;
+        int summaryThreshold = 3;
+        int notificationDelayMs = 1000;
+        int trayUnreadLimit = 5;
+        int hydrationPrefetchRows = 10;
+        int avatarCacheMb = 16;
+        int knownNotificationRetentionDays = 180;
+        QString customSortKeys = QStringLiteral("repository,reason,-updated");
+        bool notifyOnce = true;
+        bool notifyRead = false;
+    };
+
+    static Values read();
+    void watchSettingsFile();
+
+    Values m_values;
+    QFileSystemWatcher* m_watcher;
+    QTimer* m_reloadTimer;
+};
+
+#endif  // APPSETTINGS_H
@@ -0,0 +1,168 @@
+#include "AvatarStore.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <algorithm>
+
+#include "AppSettings.h"
+
+namespace {
+// Rows draw avatars at 40px; keeping twice that covers HiDPI without holding GitHub's full-size originals
+const int kMaxAvatarSide = 80;
+const quint32 kSnapshotMagic = 0x4b474156;  // "KGAV"
+const quint32 kSnapshotVersion = 1;
+
+qint64 pixmapBytes(const QPixmap& pixmap) {
+    return qMax<qint64>(1, qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8);
+}
+}  // namespace
+
+AvatarStore* AvatarStore::instance() {
+    static AvatarStore* store = new AvatarStore(qApp);
+    return store;
+}
+
+AvatarStore::AvatarStore(QObject* parent) : QObject(parent), m_manager(new QNetworkAccessManager(this)) {
+    setBudgetBytes(qint64(AppSettings::instance()->avatarCacheMb()) * 1024 * 1024);
+    connect(AppSettings::instance(), &AppSettings::valueChanged, this, [this](const QString& key) {
+        if (key == "avatarCacheMb") setBudgetBytes(qint64(AppSettings::instance()->avatarCacheMb()) * 1024 * 1024);
+    });
+}
+
+QPixmap AvatarStore::avatar(const QString& url) {
+    QPixmap* pixmap = m_cache.object(url);
+    return pixmap ? *pixmap : QPixmap();
+}
+
+void AvatarStore::request(const QString& url) {
+    if (url.isEmpty()) return;
+
+    if (QPixmap* pixmap = m_cache.object(url)) {
+        // Keep the signal asynchronous so callers see the same ordering whether or not it was cached
+        QPixmap copy = *pixmap;
+        QTimer::singleShot(0, this, [this, url, copy]() { emit avatarReady(url, copy); });
+        return;
+    }
+    if (m_inFlight.value(url)) return;
+
+    QNetworkRequest request{QUrl(url)};
+    // Avatars are public, so no auth header is needed
+    request.setRawHeader("User-Agent", "Kgithub-notify");
+
+    QNetworkReply* reply = m_manager->get(request);
+    reply->setProperty("avatarUrl", url);
+    connect(reply, &QNetworkReply::finished, this, &AvatarStore::onReplyFinished);
+    m_inFlight.insert(url, reply);
+}
+
+void AvatarStore::clear() { m_cache.clear(); }
+
+void AvatarStore::setBudgetBytes(qint64 bytes) { m_cache.setMaxCost(qMax<qint64>(bytes, 1024 * 1024)); }
+
+void AvatarStore::onReplyFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+
+    QString url = reply->property("avatarUrl").toString();
+    m_inFlight.remove(url);
+
+    if (reply->error() != QNetworkReply::NoError) {
+        qDebug() << "Error fetching avatar:" << reply->errorString();
+        emit avatarFailed(url);
+        return;
+    }
+
+    QImage image;
+    if (!image.loadFromData(reply->readAll())) {
+        emit avatarFailed(url);
+        return;
+    }
+    if (image.width() > kMaxAvatarSide || image.height() > kMaxAvatarSide) {
+        image = image.scaled(kMaxAvatarSide, kMaxAvatarSide, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+    m_cache.insert(url, new QPixmap(pixmap), pixmapBytes(pixmap));
+    emit avatarReady(url, pixmap);
+}
+
+QString AvatarStore::defaultSnapshotPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/avatars.snapshot";
+}
+
+bool AvatarStore::saveSnapshot(const QString& path, QStringList urls) {
+    urls.removeIf([this](const QString& url) { return !m_cache.contains(url); });
+    std::sort(urls.begin(), urls.end());
+    urls.erase(std::unique(urls.begin(), urls.end()), urls.end());
+    if (urls == m_snapshotUrls) return true;
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write avatar snapshot" << path << file.errorString();
+        return false;
+    }
+
+    // Uncompressed pixels: a few hundred KB at most, and nothing to decode at startup
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kSnapshotMagic << kSnapshotVersion << quint32(urls.size());
+    for (const QString& url : urls) {
+        QImage image = m_cache.object(url)->toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        out << url << qint32(image.width()) << qint32(image.height())
+            << QByteArray(reinterpret_cast<const char*>(image.constBits()), int(image.sizeInBytes()));
+    }
+    if (!file.commit()) return false;
+
+    m_snapshotUrls = urls;
+    return true;
+}
+
+int AvatarStore::loadSnapshot(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != kSnapshotMagic || version != kSnapshotVersion) return 0;
+
+    QStringList loaded;
+    for (quint32 i = 0; i < count; ++i) {
+        QString url;
+        qint32 width = 0;
+        qint32 height = 0;
+        QByteArray pixels;
+        in >> url >> width >> height >> pixels;
+        if (in.status() != QDataStream::Ok || width <= 0 || height <= 0 || width > kMaxAvatarSide ||
+            height > kMaxAvatarSide || pixels.size() != qsizetype(width) * height * 4) {
+            break;
+        }
+
+        // The image only wraps the buffer, so copy it before the buffer goes away
+        QImage image(reinterpret_cast<const uchar*>(pixels.constData()), width, height, width * 4,
+                     QImage::Format_ARGB32_Premultiplied);
+        QPixmap pixmap = QPixmap::fromImage(image.copy());
+        m_cache.insert(url, new QPixmap(pixmap), pixmapBytes(pixmap));
+        loaded.append(url);
+    }
+
+    std::sort(loaded.begin(), loaded.end());
+    m_snapshotUrls = loaded;
+    return loaded.size();
+}
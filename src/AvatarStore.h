@@ -0,0 +1,61 @@
+#ifndef AVATARSTORE_H
+#define AVATARSTORE_H
+
+#include <QCache>
+#include <QHash>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// Process-wide avatar images keyed by avatar URL, so an author's picture is held once however many
+// notifications show it.
+//
+// Decoded pixmaps live in an LRU cache charged by their byte size against a configurable budget; evicted
+// avatars are simply fetched again the next time they are asked for. The avatars shown in the list can be written
+// out as raw pixels for the next launch to show before anything has been fetched.
+class AvatarStore : public QObject {
+    Q_OBJECT
+   public:
+    static AvatarStore* instance();
+
+    // Returns the cached avatar (refreshing its LRU position) or a null pixmap
+    QPixmap avatar(const QString& url);
+    // Fetches the avatar unless it is cached or already on its way; avatarReady or avatarFailed follows
+    void request(const QString& url);
+
+    // Drops every decoded avatar; they come back from the snapshot or the network when next asked for
+    void clear();
+
+    void setBudgetBytes(qint64 bytes);
+    qint64 budgetBytes() const { return m_cache.maxCost(); }
+    qint64 usedBytes() const { return m_cache.totalCost(); }
+
+    static QString defaultSnapshotPath();
+    // Writes those of the given avatars that are cached; skipped if the set is the one written last time
+    bool saveSnapshot(const QString& path, QStringList urls);
+    // Returns the number of avatars put into the cache
+    int loadSnapshot(const QString& path);
+
+   signals:
+    void avatarReady(const QString& url, const QPixmap& pixmap);
+    // The fetch failed or the data was not an image; a later request() tries again
+    void avatarFailed(const QString& url);
+
+   private slots:
+    void onReplyFinished();
+
+   private:
+    explicit AvatarStore(QObject* parent = nullptr);
+
+    QNetworkAccessManager* m_manager;
+    QCache<QString, QPixmap> m_cache;
+    QHash<QString, QPointer<QNetworkReply>> m_inFlight;
+    QStringList m_snapshotUrls;  // Sorted; what the snapshot file holds
+};
+
+#endif  // AVATARSTORE_H
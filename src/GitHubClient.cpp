@@ -6,7 +6,6 @@
 #include <QJsonObject>
 #include <QList>
 #include <QNetworkRequest>
-#include <QPixmap>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QUrl>
@@ -41,16 +40,33 @@ QString GitHubClient::apiToHtmlUrl(const QString& apiUrl, const QString& notific
     return htmlUrl;
 }
 
-void GitHubClient::setToken(const QString& token) { m_token.set(token); }
+void GitHubClient::setToken(const QString& token) {
+    m_token.set(token);
+    m_lastModified.clear();
+}
 
-void GitHubClient::setApiUrl(const QString& url) { m_apiUrl = url; }
+void GitHubClient::setApiUrl(const QString& url) {
+    m_apiUrl = url;
+    m_lastModified.clear();
+}
 
 void GitHubClient::setShowAll(bool all) { m_showAll = all; }
 
-void GitHubClient::checkNotifications() {
+void GitHubClient::restorePaging(const QByteArray& lastModified, const QString& nextPageUrl) {
+    m_lastModified = lastModified;
+    m_nextPageUrl = nextPageUrl;
+}
+
+void GitHubClient::checkNotifications() { requestNotifications(false); }
+
+void GitHubClient::pollNotifications() { requestNotifications(true); }
+
+void GitHubClient::requestNotifications(bool conditional) {
     emit loadingStarted();
 
-    m_nextPageUrl.clear();
+    // A 304 leaves the list as it is, including which page comes next
+    conditional = conditional && !m_lastModified.isEmpty();
+    if (!conditional) m_nextPageUrl.clear();
 
     if (m_token.isEmpty()) {
         emit authError("No token provided");
@@ -64,6 +80,10 @@ void GitHubClient::checkNotifications() {
     url.setQuery(query);
 
     QNetworkRequest request = createAuthenticatedRequest(url);
+    // A 304 for this does not count against the rate limit
+    if (conditional) {
+        request.setRawHeader("If-Modified-Since", m_lastModified);
+    }
 
     if (m_activeNotificationReply) {
         m_activeNotificationReply->abort();
@@ -147,26 +167,55 @@ void GitHubClient::markAsReadAndDone(const QString& id) {
     reply->setProperty("notificationId", id);
 }
 
+void GitHubClient::triageThreads(const QStringList& markRead, const QStringList& markDone,
+                                 const QStringList& unsubscribe) {
+    if (m_token.isEmpty()) return;
+
+    auto send = [this](const QString& id, const QString& path, const QByteArray& verb) {
+        QNetworkRequest request = createAuthenticatedRequest(QUrl(m_apiUrl + path));
+        QNetworkReply* reply = manager->sendCustomRequest(request, verb);
+        reply->setProperty("type", "triage");
+        reply->setProperty("notificationId", id);
+    };
+
+    for (const QString& id : markRead) {
+        send(id, "/notifications/threads/" + id, "PATCH");
+    }
+    for (const QString& id : markDone) {
+        send(id, "/notifications/threads/" + id, "DELETE");
+    }
+    for (const QString& id : unsubscribe) {
+        send(id, "/notifications/threads/" + id + "/subscription", "DELETE");
+    }
+}
+
 void GitHubClient::fetchNotificationDetails(const QString& url, const QString& notificationId) {
-    if (m_token.isEmpty() || url.isEmpty()) return;
+    // Every request that is not sent is answered, so callers tracking requests in flight can let go of it
+    if (m_token.isEmpty()) {
+        emit detailsError(notificationId, "No token provided");
+        return;
+    }
     QUrl qUrl(url);
-    if (!qUrl.isValid()) return;
+    if (url.isEmpty() || !qUrl.isValid()) {
+        emit detailsError(notificationId, "Invalid details URL");
+        return;
+    }
+
+    // A row scrolled out and back in while its request is still running must not fetch twice; that reply answers
+    if (m_detailsReplies.value(notificationId)) return;
+
     QNetworkRequest request = createRequest(qUrl);
     QNetworkReply* reply = manager->get(request);
     reply->setProperty("type", "details");
     reply->setProperty("notificationId", notificationId);
+    m_detailsReplies.insert(notificationId, reply);
 }
 
-void GitHubClient::fetchImage(const QString& imageUrl, const QString& notificationId) {
-    QUrl qUrl(imageUrl);
-    QNetworkRequest request(qUrl);
-    // Images (avatars) are usually public, so no auth header needed.
-    // Also, User-Agent is good practice.
-    request.setRawHeader("User-Agent", "Kgithub-notify");
-
-    QNetworkReply* reply = manager->get(request);
-    reply->setProperty("type", "image");
-    reply->setProperty("notificationId", notificationId);
+void GitHubClient::cancelNotificationDetails(const QString& notificationId) {
+    QPointer<QNetworkReply> reply = m_detailsReplies.take(notificationId);
+    if (reply) {
+        reply->abort();
+    }
 }
 
 void GitHubClient::requestRaw(const QString& endpoint, const QString& method, const QByteArray& body) {
@@ -255,17 +304,22 @@ void GitHubClient::onReplyFinished(QNetworkReply* reply) {
         m_activeNotificationReply = nullptr;
     }
 
+    QString type = reply->property("type").toString();
+
+    if (type == "details") {
+        QString notificationId = reply->property("notificationId").toString();
+        if (m_detailsReplies.value(notificationId) == reply) {
+            m_detailsReplies.remove(notificationId);
+        }
+    }
+
     if (reply->error() == QNetworkReply::OperationCanceledError) {
         reply->deleteLater();
         return;
     }
 
-    QString type = reply->property("type").toString();
-
     if (type == "details") {
         handleDetailsReply(reply);
-    } else if (type == "image") {
-        handleImageReply(reply);
     } else if (type == "verification") {
         handleVerificationReply(reply);
     } else if (type == "repos") {
@@ -304,6 +358,15 @@ void GitHubClient::onReplyFinished(QNetworkReply* reply) {
         if (m_pendingPatchRequests == 0) {
             checkNotifications();
         }
+    } else if (type == "triage") {
+        if (reply->error() != QNetworkReply::NoError) {
+            if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 401) {
+                emit authError("Invalid Token");
+            } else {
+                qDebug() << "Error triaging muted thread:" << reply->errorString();
+            }
+            emit triageFailed(reply->property("notificationId").toString());
+        }
     } else if (type == "notifications") {
         handleNotificationsReply(reply);
     } else {
@@ -344,20 +407,6 @@ void GitHubClient::handleDetailsReply(QNetworkReply* reply) {
     }
 }
 
-void GitHubClient::handleImageReply(QNetworkReply* reply) {
-    QString notificationId = reply->property("notificationId").toString();
-    if (reply->error() != QNetworkReply::NoError) {
-        qDebug() << "Error fetching image:" << reply->errorString();
-        return;
-    }
-
-    QByteArray data = reply->readAll();
-    QPixmap pixmap;
-    if (pixmap.loadFromData(data)) {
-        emit imageReceived(notificationId, pixmap);
-    }
-}
-
 void GitHubClient::handleVerificationReply(QNetworkReply* reply) {
     if (reply->error() == QNetworkReply::NoError) {
         QByteArray data = reply->readAll();
@@ -428,7 +477,15 @@ void GitHubClient::handlePatchReply(QNetworkReply* reply) {
 }
 
 void GitHubClient::handleNotificationsReply(QNetworkReply* reply) {
+    emitPollHints(reply);
+
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        emit notificationsUnchanged();
+        return;
+    }
+
     if (reply->error() != QNetworkReply::NoError) {
+        emit notificationsFailed();
         if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 401) {
             emit authError("Invalid Token");
         } else {
@@ -441,6 +498,7 @@ void GitHubClient::handleNotificationsReply(QNetworkReply* reply) {
     QJsonDocument doc = QJsonDocument::fromJson(data);
 
     if (!doc.isArray()) {
+        emit notificationsFailed();
         emit errorOccurred("Invalid JSON response (expected array)");
         return;
     }
@@ -503,10 +561,28 @@ void GitHubClient::handleNotificationsReply(QNetworkReply* reply) {
     }
 
     bool append = reply->property("append").toBool();
+    if (!append && reply->hasRawHeader("Last-Modified")) {
+        m_lastModified = reply->rawHeader("Last-Modified");
+    }
     emit notificationsReceived(notifications, append, !m_nextPageUrl.isEmpty());
 }
 
+void GitHubClient::emitPollHints(QNetworkReply* reply) {
+    auto header = [reply](const char* name, qint64 fallback) {
+        bool ok = false;
+        qint64 value = reply->rawHeader(name).toLongLong(&ok);
+        return ok ? value : fallback;
+    };
+
+    int pollInterval = int(header("X-Poll-Interval", -1));
+    int remaining = int(header("X-RateLimit-Remaining", -1));
+    qint64 reset = header("X-RateLimit-Reset", -1);
+    if (pollInterval < 0 && remaining < 0 && reset < 0) return;
+    emit pollHintsReceived(pollInterval, remaining, reset);
+}
+
 void GitHubClient::onRequestTimeout() {
+    emit notificationsFailed();
     emit errorOccurred("Request timed out");
     if (m_activeNotificationReply) {
         m_activeNotificationReply->abort();
@@ -1,6 +1,7 @@
 #ifndef GITHUBCLIENT_H
 #define GITHUBCLIENT_H
 
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -9,6 +10,7 @@
 #include <QNetworkReply>
 #include <QObject>
 #include <QPointer>
+#include <QStringList>
 #include <QTimer>
 
 #include "Notification.h"
@@ -25,13 +27,22 @@ class GitHubClient : public QObject {
     void setApiUrl(const QString& url);
     void setShowAll(bool all);
     void checkNotifications();
+    // Like checkNotifications, but asks for the first page only if it changed since the last fetch
+    void pollNotifications();
+    // Validators of the last first page and the link to the page after it, for a warm start from a snapshot
+    QByteArray lastModified() const { return m_lastModified; }
+    QString nextPageUrl() const { return m_nextPageUrl; }
+    void restorePaging(const QByteArray& lastModified, const QString& nextPageUrl);
     void loadMore();
     void verifyToken();
     void markAsRead(const QString& id);
     void markAsDone(const QString& id);
     void markAsReadAndDone(const QString& id);
+    // Server-side handling of muted threads; unlike markAsRead/markAsDone these never trigger a refresh.
+    // Each thread whose request fails is reported through triageFailed().
+    void triageThreads(const QStringList& markRead, const QStringList& markDone, const QStringList& unsubscribe);
     void fetchNotificationDetails(const QString& url, const QString& notificationId);
-    void fetchImage(const QString& imageUrl, const QString& notificationId);
+    void cancelNotificationDetails(const QString& notificationId);
     void requestRaw(const QString& endpoint, const QString& method = "GET", const QByteArray& body = QByteArray());
     void fetchUserRepos(const QString& pageUrl = QString());
     void verifyRepo(const QString& repoFullName);
@@ -42,10 +53,14 @@ class GitHubClient : public QObject {
    signals:
     void loadingStarted();
     void notificationsReceived(const QList<Notification>& notifications, bool append, bool hasMore);
+    void notificationsUnchanged();
+    void notificationsFailed();
+    // Scheduling headers of a notifications reply; -1 for any that were missing
+    void pollHintsReceived(int pollIntervalSecs, int rateLimitRemaining, qint64 rateLimitReset);
     void detailsReceived(const QString& notificationId, const QString& authorName, const QString& avatarUrl,
                          const QString& htmlUrl);
     void detailsError(const QString& notificationId, const QString& error);
-    void imageReceived(const QString& notificationId, const QPixmap& avatar);
+    void triageFailed(const QString& notificationId);
     void rawDataReceived(const QByteArray& data);
     void userReposReceived(const QJsonArray& repos, const QString& nextPageUrl);
     void errorOccurred(const QString& error);
@@ -65,18 +80,21 @@ class GitHubClient : public QObject {
     bool m_showAll;
     int m_pendingPatchRequests;
     QString m_nextPageUrl;
+    QByteArray m_lastModified;  // Of the last full first page, for conditional polls
     QPointer<QNetworkReply> m_activeNotificationReply;
+    QHash<QString, QPointer<QNetworkReply>> m_detailsReplies;
     QTimer* m_requestTimeoutTimer;
 
     QNetworkRequest createRequest(const QUrl& url) const;
+    void requestNotifications(bool conditional);
 
     void handleDetailsReply(QNetworkReply* reply);
-    void handleImageReply(QNetworkReply* reply);
     void handleVerificationReply(QNetworkReply* reply);
     void handleUserReposReply(QNetworkReply* reply);
     void handleRepoVerifyReply(QNetworkReply* reply);
     void handlePatchReply(QNetworkReply* reply);
     void handleNotificationsReply(QNetworkReply* reply);
+    void emitPollHints(QNetworkReply* reply);
 };
 
 #endif  // GITHUBCLIENT_H
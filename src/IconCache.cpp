@@ -0,0 +1,90 @@
+#include "IconCache.h"
+
+#include <QApplication>
+#include <QEvent>
+#include <QPainter>
+
+IconCache* IconCache::instance() {
+    // Parented to the application so it goes away before the GUI is torn down
+    static IconCache* cache = new IconCache(qApp);
+    return cache;
+}
+
+IconCache::IconCache(QObject* parent) : QObject(parent) {
+    if (qApp) qApp->installEventFilter(this);
+}
+
+QIcon IconCache::themedIcon(const QStringList& names, QStyle::StandardPixmap fallback) {
+    QString key = names.join('|') + '#' + QString::number(fallback);
+    auto it = m_icons.constFind(key);
+    if (it != m_icons.constEnd()) return it.value();
+
+    QIcon icon;
+    for (const QString& name : names) {
+        if (QIcon::hasThemeIcon(name)) {
+            icon = QIcon::fromTheme(name);
+            break;
+        }
+    }
+    if (icon.isNull()) {
+        if (fallback != QStyle::SP_CustomBase) {
+            icon = QApplication::style()->standardIcon(fallback);
+        } else if (!names.isEmpty()) {
+            icon = QIcon::fromTheme(names.first());
+        }
+    }
+
+    m_icons.insert(key, icon);
+    return icon;
+}
+
+QPixmap IconCache::dot(int size, const QColor& color, qreal devicePixelRatio) {
+    QString key = QStringLiteral("dot:%1:%2:%3").arg(size).arg(color.rgba()).arg(devicePixelRatio);
+    auto it = m_pixmaps.constFind(key);
+    if (it != m_pixmaps.constEnd()) return it.value();
+
+    QPixmap pixmap(qRound(size * devicePixelRatio), qRound(size * devicePixelRatio));
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter p(&pixmap);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setBrush(color);
+        p.setPen(Qt::NoPen);
+        p.drawEllipse(0, 0, size, size);
+    }
+
+    m_pixmaps.insert(key, pixmap);
+    return pixmap;
+}
+
+QPixmap IconCache::placeholder(int size, qreal devicePixelRatio) {
+    QString key = QStringLiteral("placeholder:%1:%2").arg(size).arg(devicePixelRatio);
+    auto it = m_pixmaps.constFind(key);
+    if (it != m_pixmaps.constEnd()) return it.value();
+
+    QPixmap pixmap(qRound(size * devicePixelRatio), qRound(size * devicePixelRatio));
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::lightGray);
+
+    m_pixmaps.insert(key, pixmap);
+    return pixmap;
+}
+
+void IconCache::clear() {
+    m_icons.clear();
+    m_pixmaps.clear();
+}
+
+bool IconCache::eventFilter(QObject* watched, QEvent* event) {
+    // Filters on the application see every object's events; widget-level StyleChange (sent by each
+    // setStyleSheet call) is ignored, only the application-wide theme and palette notifications count
+    if (watched == qApp &&
+        (event->type() == QEvent::ThemeChange || event->type() == QEvent::ApplicationPaletteChange)) {
+        if (!m_icons.isEmpty() || !m_pixmaps.isEmpty()) {
+            clear();
+            emit invalidated();
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
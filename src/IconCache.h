@@ -0,0 +1,42 @@
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QColor>
+#include <QHash>
+#include <QIcon>
+#include <QObject>
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QStyle>
+
+// Process-wide cache of the theme icons and small generated pixmaps used by every list row.
+//
+// Icons are resolved once per name list and pixmaps are painted once per size, colour and device pixel ratio;
+// callers get implicitly shared copies. Everything is dropped when the application's icon theme or palette changes.
+class IconCache : public QObject {
+    Q_OBJECT
+   public:
+    static IconCache* instance();
+
+    // First theme icon that exists, else the style's fallback (or the bare theme lookup when there is none)
+    QIcon themedIcon(const QStringList& names, QStyle::StandardPixmap fallback = QStyle::SP_CustomBase);
+    QPixmap dot(int size, const QColor& color, qreal devicePixelRatio);
+    QPixmap placeholder(int size, qreal devicePixelRatio);
+
+    void clear();
+
+   signals:
+    void invalidated();
+
+   protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+   private:
+    explicit IconCache(QObject* parent = nullptr);
+
+    QHash<QString, QIcon> m_icons;
+    QHash<QString, QPixmap> m_pixmaps;
+};
+
+#endif  // ICONCACHE_H
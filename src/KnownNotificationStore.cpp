@@ -0,0 +1,214 @@
+#include "KnownNotificationStore.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTimer>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+namespace {
+// Re-logging a known id refreshes its timestamp, but at most once a day so repeated polls stay cheap
+const qint64 kRefreshSecs = 24 * 60 * 60;
+// Below this many superseded lines rewriting the log costs more than replaying it
+const int kMinDeadLinesForCompaction = 512;
+const int kFlushDelayMs = 2000;
+
+QString legacyDirectoryPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/known_notifications";
+}
+}  // namespace
+
+KnownNotificationStore::KnownNotificationStore(const QString& logPath, QObject* parent)
+    : QObject(parent), m_logPath(logPath), m_deadLines(0) {
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushDelayMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &KnownNotificationStore::flush);
+}
+
+KnownNotificationStore::~KnownNotificationStore() { flush(); }
+
+QString KnownNotificationStore::defaultLogPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/known_notifications.log";
+}
+
+void KnownNotificationStore::load(int retentionDays) {
+    m_lastSeen.clear();
+    m_pending.clear();
+    m_deadLines = 0;
+
+    QFile file(m_logPath);
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine().trimmed();
+            if (line.size() < 2) continue;
+
+            if (line.at(0) == '+') {
+                int tab = line.indexOf('\t');
+                QString id = QString::fromUtf8(line.mid(1, tab < 0 ? -1 : tab - 1));
+                qint64 seen = tab < 0 ? 0 : line.mid(tab + 1).toLongLong();
+                if (m_lastSeen.contains(id)) {
+                    m_deadLines++;
+                }
+                m_lastSeen.insert(id, seen);
+            } else if (line.at(0) == '-') {
+                // The removal and the entry it cancels are both dead weight
+                m_deadLines += m_lastSeen.remove(QString::fromUtf8(line.mid(1))) ? 2 : 1;
+            } else {
+                m_deadLines++;
+            }
+        }
+    }
+
+    if (m_logPath.isEmpty()) return;
+
+    migrateLegacyDirectory();
+
+    bool pruned = false;
+    if (retentionDays > 0) {
+        qint64 cutoff = QDateTime::currentSecsSinceEpoch() - qint64(retentionDays) * 24 * 60 * 60;
+        for (auto it = m_lastSeen.begin(); it != m_lastSeen.end();) {
+            if (it.value() < cutoff) {
+                it = m_lastSeen.erase(it);
+                pruned = true;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (pruned) {
+        compact();
+    } else {
+        compactIfWorthwhile();
+    }
+}
+
+bool KnownNotificationStore::insert(const QString& id) {
+    if (id.isEmpty() || id.contains('\n') || id.contains('\t')) return false;
+
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    auto it = m_lastSeen.find(id);
+    if (it != m_lastSeen.end()) {
+        if (now - it.value() >= kRefreshSecs) {
+            it.value() = now;
+            m_deadLines++;
+            appendLine("+" + id.toUtf8() + "\t" + QByteArray::number(now));
+        }
+        return false;
+    }
+
+    m_lastSeen.insert(id, now);
+    appendLine("+" + id.toUtf8() + "\t" + QByteArray::number(now));
+    return true;
+}
+
+void KnownNotificationStore::remove(const QString& id) {
+    if (!m_lastSeen.remove(id)) return;
+
+    m_deadLines += 2;
+    appendLine("-" + id.toUtf8());
+}
+
+void KnownNotificationStore::clear() {
+    m_lastSeen.clear();
+    m_pending.clear();
+    m_flushTimer->stop();
+    compact();
+}
+
+void KnownNotificationStore::flush() {
+    m_flushTimer->stop();
+    if (m_pending.isEmpty() || m_logPath.isEmpty()) {
+        m_pending.clear();
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(m_logPath).absolutePath());
+    QFile file(m_logPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Failed to append known notifications to" << m_logPath << file.errorString();
+        return;
+    }
+    file.write(m_pending);
+    file.flush();
+#ifdef __unix__
+    ::fsync(file.handle());
+#endif
+    m_pending.clear();
+
+    compactIfWorthwhile();
+}
+
+bool KnownNotificationStore::compact() {
+    if (m_logPath.isEmpty()) return false;
+
+    QDir().mkpath(QFileInfo(m_logPath).absolutePath());
+    QSaveFile file(m_logPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to compact known notifications log" << m_logPath << file.errorString();
+        return false;
+    }
+
+    QByteArray data;
+    data.reserve(m_lastSeen.size() * 24);
+    for (auto it = m_lastSeen.constBegin(); it != m_lastSeen.constEnd(); ++it) {
+        data += '+';
+        data += it.key().toUtf8();
+        data += '\t';
+        data += QByteArray::number(it.value());
+        data += '\n';
+    }
+    file.write(data);
+
+    // QSaveFile syncs before renaming over the old log, so a crash leaves either the old or the new file
+    if (!file.commit()) {
+        qWarning() << "Failed to replace known notifications log" << m_logPath << file.errorString();
+        return false;
+    }
+    m_pending.clear();
+    m_flushTimer->stop();
+    m_deadLines = 0;
+    return true;
+}
+
+void KnownNotificationStore::appendLine(const QByteArray& line) {
+    m_pending += line;
+    m_pending += '\n';
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void KnownNotificationStore::migrateLegacyDirectory() {
+    QDir dir(legacyDirectoryPath());
+    if (!dir.exists()) return;
+
+    // Old entries only recorded when a thread was first seen, so treat them all as seen now and let the
+    // retention window start from the migration
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    const QStringList files = dir.entryList(QDir::Files);
+    for (const QString& id : files) {
+        m_lastSeen.insert(id, now);
+    }
+
+    // Only drop the old files once their contents are safely in the log
+    if (compact()) {
+        qDebug() << "Migrated" << files.size() << "known notifications from" << dir.path();
+        dir.removeRecursively();
+    }
+}
+
+void KnownNotificationStore::compactIfWorthwhile() {
+    if (m_deadLines >= kMinDeadLinesForCompaction && m_deadLines > m_lastSeen.size()) {
+        compact();
+    }
+}
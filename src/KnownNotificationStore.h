@@ -0,0 +1,48 @@
+#ifndef KNOWNNOTIFICATIONSTORE_H
+#define KNOWNNOTIFICATIONSTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+class QTimer;
+
+// Remembers which notification threads have already been announced, for "notify once".
+//
+// Entries live in a single append-only log ("+id<TAB>seconds" to add or refresh, "-id" to forget) that is
+// rewritten from the in-memory set once superseded lines outnumber live ones. Appends are batched and synced
+// on a short timer, and entries not seen within the retention window are pruned on load, so startup cost
+// tracks the live set rather than every thread ever seen. An empty log path keeps the set in memory only.
+class KnownNotificationStore : public QObject {
+    Q_OBJECT
+   public:
+    explicit KnownNotificationStore(const QString& logPath, QObject* parent = nullptr);
+    ~KnownNotificationStore();
+
+    static QString defaultLogPath();
+
+    void load(int retentionDays);
+    bool contains(const QString& id) const { return m_lastSeen.contains(id); }
+    // Returns true if the id was not known before
+    bool insert(const QString& id);
+    void remove(const QString& id);
+    void clear();
+    int size() const { return m_lastSeen.size(); }
+
+    void flush();
+    bool compact();
+
+   private:
+    void appendLine(const QByteArray& line);
+    void migrateLegacyDirectory();
+    void compactIfWorthwhile();
+
+    QString m_logPath;
+    QHash<QString, qint64> m_lastSeen;
+    QByteArray m_pending;
+    int m_deadLines;
+    QTimer* m_flushTimer;
+};
+
+#endif  // KNOWNNOTIFICATIONSTORE_H
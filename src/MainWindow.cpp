@@ -11,6 +11,8 @@
 #include <QDate>
 #include <QDebug>
 #include <QDesktopServices>
+#include <QElapsedTimer>
+#include <QInputDialog>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -18,6 +20,7 @@
 #include <QLocale>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QPixmapCache>
 #include <QPointer>
 #include <QProcess>
 #include <QScreen>
@@ -27,31 +30,41 @@
 #include <QUrl>
 #include <QVBoxLayout>
 #include <QtGui/QAction>
-#include <limits>
+#include <memory>
 
+#include "AppSettings.h"
+#include "AvatarStore.h"
 #include "DebugWindow.h"
 #include "NewIssueDialog.h"
+#include "NotificationDispatcher.h"
+#include "NotificationEngine.h"
 #include "NotificationItemWidget.h"
 #include "NotificationListWidget.h"
-#include "NotificationRuleEngine.h"
+#include "NotificationSnapshot.h"
+#include "NotificationStore.h"
+#include "PollScheduler.h"
 #include "RepoListWindow.h"
 #include "RulesDialog.h"
 #include "SettingsDialog.h"
+#include "StartupProfiler.h"
 #include "WorkItemWindow.h"
 #include "trending/TrendingWindow.h"
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 // -----------------------------------------------------------------------------
 // Constants / Static Helpers
 // -----------------------------------------------------------------------------
 
-static int calculateSafeInterval(int minutes) {
-    if (minutes <= 0) minutes = 1;  // Minimum 1 minute
-    qint64 msec = static_cast<qint64>(minutes) * 60 * 1000;
-    if (msec > std::numeric_limits<int>::max()) {
-        return std::numeric_limits<int>::max();
-    }
-    return static_cast<int>(msec);
-}
+// How long the window stays hidden before its views are released
+static const int kTrayResidentDelayMs = 10 * 60 * 1000;
+
+// Filter entries that show an unread count carry the reason they count ("" for every reason) and the label the
+// count goes into; the entry's position stays the filter mode
+static const int kFilterReasonRole = Qt::UserRole;
+static const int kFilterCountLabelRole = Qt::UserRole + 1;
 
 // -----------------------------------------------------------------------------
 // Constructor / Destructor
@@ -67,18 +80,62 @@ MainWindow::MainWindow(QWidget* parent)
       notificationListWidget(nullptr),
       client(nullptr),
       pendingAuthError(false),
-      m_lastUnreadCount(0) {
+      errorPage(nullptr),
+      errorLabel(nullptr),
+      settingsButton(nullptr),
+      loginPage(nullptr),
+      loginLabel(nullptr),
+      loginButton(nullptr),
+      emptyStatePage(nullptr),
+      emptyStateLabel(nullptr),
+      m_trayResident(false),
+      m_lastUnreadCount(0),
+      m_trayUnreadLimit(SettingsDialog::getTrayUnreadLimit()) {
+    m_engine = new NotificationEngine(this);
+    m_engine->setOfferOpenApp(true);
+    m_pollScheduler = m_engine->pollScheduler();
+    connect(m_engine, &NotificationEngine::popupActivated, this, [this](const QString& id) {
+        if (!id.isEmpty() && notificationListWidget) notificationListWidget->focusNotification(id);
+        ensureWindowActive();
+    });
+    connect(m_engine->dispatcher(), &NotificationDispatcher::queueDepthChanged, this, &MainWindow::updateTrayToolTip);
+
+    // Picks up changes from the settings dialog as well as edits to the file while running
+    AppSettings::instance()->setWatchFile(true);
+    connect(AppSettings::instance(), &AppSettings::valueChanged, this, &MainWindow::onSettingChanged);
+
+    StartupProfiler::mark(QStringLiteral("scheduler and settings"));
+
     setupWindow();
     setupCentralWidget();
     setupNotificationList();
+    StartupProfiler::mark(QStringLiteral("notification list"));
     setupToolbar();
     setupPages();
     createTrayIcon();
+    StartupProfiler::mark(QStringLiteral("toolbar and tray"));
     setupMenus();
+    StartupProfiler::mark(QStringLiteral("menus and xmlgui"));
     setupStatusBar();
 
+    m_snapshotTimer = new QTimer(this);
+    m_snapshotTimer->setSingleShot(true);
+    m_snapshotTimer->setInterval(2000);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &MainWindow::saveSnapshot);
+    // Before main() unwinds: the client does not outlive the event loop
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &MainWindow::saveSnapshot);
+
+    // Started here too, so instances that start in the tray and are never opened get there as well
+    m_trayResidentTimer = new QTimer(this);
+    m_trayResidentTimer->setSingleShot(true);
+    m_trayResidentTimer->setInterval(kTrayResidentDelayMs);
+    connect(m_trayResidentTimer, &QTimer::timeout, this, &MainWindow::enterTrayResidentMode);
+    m_trayResidentTimer->start();
+
     // Initial State Check
     stackWidget->setCurrentWidget(loadingPage);
+    restoreSnapshot();
+    StartupProfiler::mark(QStringLiteral("snapshot restore"));
 
     loadToken();
 }
@@ -99,29 +156,27 @@ void MainWindow::setClient(GitHubClient* c) {
     connect(client, &GitHubClient::notificationsReceived, this, &MainWindow::updateNotifications);
     connect(client, &GitHubClient::errorOccurred, this, &MainWindow::showError);
     connect(client, &GitHubClient::authError, this, &MainWindow::onAuthError);
+    connect(client, &GitHubClient::notificationsUnchanged, this, &MainWindow::onNotificationsUnchanged);
 
     notificationListWidget->setClient(client);
 
     connect(client, &GitHubClient::detailsError, notificationListWidget, &NotificationListWidget::updateError);
     connect(client, &GitHubClient::detailsReceived, notificationListWidget, &NotificationListWidget::updateDetails);
-    connect(client, &GitHubClient::imageReceived, notificationListWidget, &NotificationListWidget::updateImage);
 
     // Wire up ListWidget requests
     connect(notificationListWidget, &NotificationListWidget::requestDetails, client,
             &GitHubClient::fetchNotificationDetails);
-    connect(notificationListWidget, &NotificationListWidget::requestImage, client, &GitHubClient::fetchImage);
+    connect(notificationListWidget, &NotificationListWidget::cancelDetails, client,
+            &GitHubClient::cancelNotificationDetails);
     connect(notificationListWidget, &NotificationListWidget::markAsRead, client, &GitHubClient::markAsRead);
+    connect(notificationListWidget, &NotificationListWidget::markAsRead, m_engine, &NotificationEngine::threadRead);
     connect(notificationListWidget, &NotificationListWidget::requestDebugApi, this,
             [this](const QString& url) { showDebugWindow(url); });
     connect(notificationListWidget, &NotificationListWidget::markAsDone, client, &GitHubClient::markAsDone);
+    connect(notificationListWidget, &NotificationListWidget::markAsDone, m_engine, &NotificationEngine::threadRead);
     connect(notificationListWidget, &NotificationListWidget::loadMoreRequested, client, &GitHubClient::loadMore);
 
-    if (refreshTimer) {
-        connect(refreshTimer, &QTimer::timeout, client, &GitHubClient::checkNotifications);
-        int interval = SettingsDialog::getInterval();
-        refreshTimer->setInterval(calculateSafeInterval(interval));
-        refreshTimer->start();
-    }
+    m_engine->setClient(client);
 
     if (!m_loadedToken.isEmpty()) {
         client->setToken(m_loadedToken);
@@ -156,22 +211,35 @@ void MainWindow::updateNotifications(const QList<Notification>& notifications, b
     pendingAuthError = false;
     lastError.clear();
 
-    notificationListWidget->setNotifications(notifications, append, hasMore);
-
-    updateSelectionComboBox();
+    QList<Notification> visible = m_engine->ingest(notifications, append);
+    notificationListWidget->setMutedThreads(m_engine->mutedThreads());
+    notificationListWidget->setNotifications(visible, append, hasMore);
+    m_snapshotTimer->start();
 
     if (statusLabel) {
         statusLabel->setText(tr("Updated"));
     }
 }
 
+void MainWindow::onNotificationsUnchanged() {
+    m_lastCheckTime = QDateTime::currentDateTime();
+    pendingAuthError = false;
+    lastError.clear();
+    if (client) notificationListWidget->confirmSnapshot(!client->nextPageUrl().isEmpty());
+
+    if (statusLabel) {
+        statusLabel->setText(tr("Up to date"));
+    }
+    updateTrayToolTip();
+}
+
 void MainWindow::onListCountsChanged(int total, int unread, int newCount, const QList<Notification>& newItems) {
     m_lastUnreadCount = unread;
     updateTrayIconState(unread, newCount, newItems);
 
     if (total == 0) {
         if (stackWidget->currentWidget() != emptyStatePage) {
-            stackWidget->setCurrentWidget(emptyStatePage);
+            stackWidget->setCurrentWidget(ensureEmptyStatePage());
         }
     } else {
         if (stackWidget->currentWidget() != notificationListWidget) {
@@ -183,7 +251,29 @@ void MainWindow::onListCountsChanged(int total, int unread, int newCount, const
         countLabel->setText(tr("Items: %1").arg(total));
     }
 
-    // Update repo filter
+    updateSelectionComboBox();
+}
+
+void MainWindow::onStoreCountsChanged(int total, int unread) {
+    Q_UNUSED(total);
+    m_lastUnreadCount = unread;
+    updateFilterCounts();
+    updateTrayToolTip();
+}
+
+void MainWindow::updateFilterCounts() {
+    NotificationStore* store = notificationListWidget->store();
+    for (int i = 0; i < filterComboBox->count(); ++i) {
+        QVariant reason = filterComboBox->itemData(i, kFilterReasonRole);
+        if (!reason.isValid()) continue;
+
+        QString reasonText = reason.toString();
+        int unread = reasonText.isEmpty() ? store->unreadCount() : store->unreadCountForReason(reasonText);
+        filterComboBox->setItemText(i, filterComboBox->itemData(i, kFilterCountLabelRole).toString().arg(unread));
+    }
+}
+
+void MainWindow::updateRepoFilter() {
     QString currentRepo = repoFilterComboBox->currentText();
     bool wasBlocked = repoFilterComboBox->blockSignals(true);
     repoFilterComboBox->clear();
@@ -241,6 +331,7 @@ void MainWindow::showError(const QString& error) {
 void MainWindow::onAuthError(const QString& message) {
     pendingAuthError = true;
 
+    ensureErrorPage();
     errorLabel->setText(tr("Authentication Error: %1\n\nPlease update your token in Settings.").arg(message));
     stackWidget->setCurrentWidget(errorPage);
 
@@ -293,17 +384,20 @@ void MainWindow::onTrayMessageClicked() {
 void MainWindow::showSettings() {
     SettingsDialog dialog(this);
     if (dialog.exec() == QDialog::Accepted) {
-        QString newToken = dialog.getToken();
-        int interval = SettingsDialog::getInterval();
+        QString newToken = dialog.token();
         if (client) {
             client->setToken(newToken);
             client->checkNotifications();
         }
-        if (refreshTimer) {
-            refreshTimer->setInterval(calculateSafeInterval(interval));
-            refreshTimer->start();
-            updateStatusBar();
-        }
+        m_pollScheduler->notePoll();
+    }
+}
+
+void MainWindow::onSettingChanged(const QString& key) {
+    // The engine follows the poll interval and popup delay itself
+    if (key == "trayUnreadLimit") {
+        m_trayUnreadLimit = SettingsDialog::getTrayUnreadLimit();
+        updateTrayMenu();
     }
 }
 
@@ -327,52 +421,105 @@ void MainWindow::onLoadingStarted() {
 
 void MainWindow::onAuthNotificationSettingsClicked() { showSettings(); }
 
-void MainWindow::dismissAllNotifications() {
-    notificationListWidget->selectAll();
-    notificationListWidget->dismissSelected();
-}
+void MainWindow::dismissAllNotifications() { notificationListWidget->dismissAll(); }
 
 void MainWindow::onTokenLoaded() {
-    m_loadedToken = tokenWatcher->result();
+    WalletManager::Result result = tokenWatcher->result();
+    m_loadedToken = result.token;
 
     authNotificationSent = false;
 
-    if (m_loadedToken.isEmpty()) {
-        stackWidget->setCurrentWidget(loginPage);
+    if (!result.ok()) {
+        // A restored list stays on screen; otherwise say why nothing can be fetched
+        if (notificationListWidget->count() == 0) {
+            ensureErrorPage();
+            errorLabel->setText(tr("Could not read your token: %1.\n\nCheck that KWallet is running and unlocked, "
+                                   "or enter the token again in Settings.")
+                                    .arg(result.errorString()));
+            stackWidget->setCurrentWidget(errorPage);
+        }
+        if (statusLabel) {
+            statusLabel->setText(tr("Wallet error"));
+        }
+    } else if (m_loadedToken.isEmpty()) {
+        stackWidget->setCurrentWidget(ensureLoginPage());
     } else {
         stackWidget->setCurrentWidget(notificationListWidget);
         if (client) {
             client->setToken(m_loadedToken);
-            client->checkNotifications();
+            if (notificationListWidget->isStale()) {
+                // The list on screen came from the snapshot; a 304 confirms it without using the rate limit
+                client->restorePaging(m_snapshotLastModified, m_snapshotNextPageUrl);
+                client->pollNotifications();
+            } else {
+                client->checkNotifications();
+            }
+            m_pollScheduler->notePoll();
         }
     }
 }
 
+void MainWindow::restoreSnapshot() {
+    QElapsedTimer timer;
+    timer.start();
+
+    NotificationSnapshot snapshot = NotificationSnapshot::load(NotificationSnapshot::defaultPath());
+    if (snapshot.isEmpty()) return;
+    int avatars = AvatarStore::instance()->loadSnapshot(AvatarStore::defaultSnapshotPath());
+
+    m_snapshotLastModified = snapshot.lastModified;
+    m_snapshotNextPageUrl = snapshot.nextPageUrl;
+    m_lastCheckTime = snapshot.savedAt;
+    notificationListWidget->restoreSnapshot(snapshot.notifications, snapshot.savedAt);
+    stackWidget->setCurrentWidget(notificationListWidget);
+    if (statusLabel) {
+        statusLabel->setText(tr("Saved copy"));
+    }
+
+    qDebug() << "Restored" << snapshot.notifications.size() << "notifications and" << avatars
+             << "avatars from the snapshot in" << timer.elapsed() << "ms";
+}
+
+void MainWindow::saveSnapshot() {
+    m_snapshotTimer->stop();
+    // Nothing fetched yet means nothing newer than the file already on disk
+    if (!client || notificationListWidget->isStale() || !m_lastCheckTime.isValid()) return;
+
+    NotificationSnapshot snapshot;
+    snapshot.notifications = notificationListWidget->allNotifications();
+    snapshot.savedAt = m_lastCheckTime;
+    snapshot.lastModified = client->lastModified();
+    snapshot.nextPageUrl = client->nextPageUrl();
+    snapshot.save(NotificationSnapshot::defaultPath());
+    AvatarStore::instance()->saveSnapshot(AvatarStore::defaultSnapshotPath(), notificationListWidget->avatarUrls());
+}
+
 void MainWindow::onRefreshClicked() {
     if (!client) return;
 
     client->checkNotifications();
-
-    if (refreshTimer) {
-        refreshTimer->start();
-        updateStatusBar();
-    }
+    m_pollScheduler->notePoll();
+    m_pollScheduler->noteActivity();
 }
 
 void MainWindow::updateStatusBar() {
-    if (refreshTimer && refreshTimer->isActive()) {
-        qint64 remaining = refreshTimer->remainingTime();
-        if (remaining >= 0) {
-            int seconds = (remaining / 1000) % 60;
-            int minutes = (remaining / 60000);
-            timerLabel->setText(
-                tr("Next refresh: %1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds, 2, 10, QChar('0')));
-            return;
-        }
+    if (!timerLabel) return;
+
+    if (m_pollScheduler->isPaused()) {
+        timerLabel->setText(m_pollScheduler->pauseReasons() & PollScheduler::Offline ? tr("Paused (offline)")
+                                                                                      : tr("Paused (screen locked)"));
+        return;
     }
-    if (timerLabel) {
-        timerLabel->setText(tr("Next refresh: --:--"));
+
+    qint64 remaining = m_pollScheduler->remainingMs();
+    if (remaining >= 0) {
+        int seconds = (remaining / 1000) % 60;
+        int minutes = (remaining / 60000);
+        timerLabel->setText(
+            tr("Next refresh: %1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds, 2, 10, QChar('0')));
+        return;
     }
+    timerLabel->setText(tr("Next refresh: --:--"));
 }
 
 void MainWindow::onSelectAllClicked() {
@@ -419,10 +566,7 @@ void MainWindow::onFilterChanged(int index) {
         notificationListWidget->setFilterMode(index);
     }
 
-    if (refreshTimer) {
-        refreshTimer->start();
-        updateStatusBar();
-    }
+    m_pollScheduler->noteActivity();
 }
 
 void MainWindow::showAboutDialog() {
@@ -498,8 +642,54 @@ void MainWindow::closeEvent(QCloseEvent* event) {
     }
 }
 
+void MainWindow::showEvent(QShowEvent* event) {
+    KXmlGuiWindow::showEvent(event);
+    m_trayResidentTimer->stop();
+    leaveTrayResidentMode();
+}
+
+void MainWindow::hideEvent(QHideEvent* event) {
+    KXmlGuiWindow::hideEvent(event);
+    m_trayResidentTimer->start();
+}
+
+void MainWindow::enterTrayResidentMode() {
+    if (m_trayResident || (isVisible() && !isMinimized())) return;
+    m_trayResident = true;
+    qDebug() << "Window hidden for" << kTrayResidentDelayMs / 60000 << "minutes, releasing views";
+
+    // The avatars on disk are what the next show reads back instead of fetching them again
+    m_snapshotTimer->stop();
+    saveSnapshot();
+
+    notificationListWidget->releaseViews();
+    AvatarStore::instance()->clear();
+    QPixmapCache::clear();
+
+    // Closed secondary windows are only hidden and still hold whatever they last loaded
+    if (repoListWindow && !repoListWindow->isVisible()) repoListWindow->deleteLater();
+    if (trendingWindow && !trendingWindow->isVisible()) trendingWindow->deleteLater();
+    if (debugWindow && !debugWindow->isVisible()) debugWindow->deleteLater();
+
+#ifdef __GLIBC__
+    // glibc keeps freed memory in the heap for reuse; hand it back once the deferred deletes have run
+    QTimer::singleShot(1000, this, [this]() {
+        if (m_trayResident) malloc_trim(0);
+    });
+#endif
+}
+
+void MainWindow::leaveTrayResidentMode() {
+    if (!m_trayResident) return;
+    m_trayResident = false;
+
+    AvatarStore::instance()->loadSnapshot(AvatarStore::defaultSnapshotPath());
+    notificationListWidget->restoreViews();
+}
+
 void MainWindow::createTrayIcon() {
     trayIconMenu = new QMenu(this);
+    buildTrayMenu();
 
     trayIcon = new QSystemTrayIcon(this);
     trayIcon->setContextMenu(trayIconMenu);
@@ -515,88 +705,115 @@ void MainWindow::createTrayIcon() {
     trayIcon->show();
 }
 
-void MainWindow::updateTrayMenu() {
-    if (!trayIcon) return;
-    QMenu* newTrayIconMenu = new QMenu(this);
-
+void MainWindow::buildTrayMenu() {
     QAction* openAppAction =
-        new QAction(themedIcon({QStringLiteral("kgithub-notify")}), tr("Open Kgithub-notify"), newTrayIconMenu);
+        new QAction(themedIcon({QStringLiteral("kgithub-notify")}), tr("Open Kgithub-notify"), trayIconMenu);
     QFont font = openAppAction->font();
     font.setBold(true);
     openAppAction->setFont(font);
     connect(openAppAction, &QAction::triggered, this, &QWidget::showNormal);
-    newTrayIconMenu->addAction(openAppAction);
-
-    newTrayIconMenu->addSeparator();
-
-    int unreadCount = m_lastUnreadCount;
-    QList<Notification> unreadNotifications =
-        notificationListWidget ? notificationListWidget->getUnreadNotifications() : QList<Notification>();
-
-    if (unreadCount > 0) {
-        QMenu* unreadMenu = new QMenu(tr("%1 Unread Notifications").arg(unreadCount), newTrayIconMenu);
-        newTrayIconMenu->addMenu(unreadMenu);
+    trayIconMenu->addAction(openAppAction);
 
-        int limit = qMin(static_cast<int>(unreadNotifications.size()), SettingsDialog::getTrayUnreadLimit());
-        for (int i = 0; i < limit; ++i) {
-            const Notification& n = unreadNotifications[i];
-            QString label = QString("%1: %2").arg(n.repository, n.title);
+    trayIconMenu->addSeparator();
 
-            QAction* itemAction = new QAction(label, unreadMenu);
-            QString id = n.id;
-            QString url = n.url;
+    m_trayUnreadMenu = new QMenu(trayIconMenu);
+    m_trayUnreadMenuAction = trayIconMenu->addMenu(m_trayUnreadMenu);
 
-            connect(itemAction, &QAction::triggered, [this, url, id]() {
-                if (client) client->markAsRead(id);
-                QString htmlUrl = GitHubClient::apiToHtmlUrl(url, id);
-                QDesktopServices::openUrl(QUrl(htmlUrl));
+    // Unread entries are inserted above this separator by updateTrayMenu()
+    m_trayUnreadSeparator = m_trayUnreadMenu->addSeparator();
 
-                if (notificationListWidget) notificationListWidget->focusNotification(id);
-            });
-            unreadMenu->addAction(itemAction);
+    QAction* dismissAllAction = new QAction(tr("Dismiss All"), m_trayUnreadMenu);
+    connect(dismissAllAction, &QAction::triggered, this, [this]() {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, tr("Dismiss All"), tr("Are you sure you want to dismiss all unread notifications?"),
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply == QMessageBox::Yes) {
+            this->dismissAllNotifications();
         }
+    });
+    m_trayUnreadMenu->addAction(dismissAllAction);
 
-        unreadMenu->addSeparator();
-
-        QAction* dismissAllAction = new QAction(tr("Dismiss All"), unreadMenu);
-        connect(dismissAllAction, &QAction::triggered, this, [this]() {
-            QMessageBox::StandardButton reply = QMessageBox::question(
-                this, tr("Dismiss All"), tr("Are you sure you want to dismiss all unread notifications?"),
-                QMessageBox::Yes | QMessageBox::No);
-            if (reply == QMessageBox::Yes) {
-                this->dismissAllNotifications();
-            }
-        });
-        unreadMenu->addAction(dismissAllAction);
-    } else {
-        QAction* empty = new QAction(tr("No new notifications"), newTrayIconMenu);
-        empty->setEnabled(false);
-        newTrayIconMenu->addAction(empty);
-    }
+    m_trayEmptyAction = new QAction(tr("No new notifications"), trayIconMenu);
+    m_trayEmptyAction->setEnabled(false);
+    trayIconMenu->addAction(m_trayEmptyAction);
 
-    newTrayIconMenu->addSeparator();
+    trayIconMenu->addSeparator();
 
     QAction* trayRefreshAction =
-        new QAction(themedIcon({QStringLiteral("view-refresh")}), tr("Force Refresh"), newTrayIconMenu);
+        new QAction(themedIcon({QStringLiteral("view-refresh")}), tr("Force Refresh"), trayIconMenu);
     connect(trayRefreshAction, &QAction::triggered, this, &MainWindow::onRefreshClicked);
-    newTrayIconMenu->addAction(trayRefreshAction);
+    trayIconMenu->addAction(trayRefreshAction);
 
-    QAction* newIssueTrayAction = new QAction(tr("New Issue..."), newTrayIconMenu);
+    QAction* newIssueTrayAction = new QAction(tr("New Issue..."), trayIconMenu);
     connect(newIssueTrayAction, &QAction::triggered, this, &MainWindow::showNewIssueDialog);
-    newTrayIconMenu->addAction(newIssueTrayAction);
+    trayIconMenu->addAction(newIssueTrayAction);
 
-    newTrayIconMenu->addSeparator();
+    trayIconMenu->addSeparator();
 
-    QAction* quitAction = new QAction(themedIcon({QStringLiteral("application-exit")}), tr("Quit"), newTrayIconMenu);
+    QAction* quitAction = new QAction(themedIcon({QStringLiteral("application-exit")}), tr("Quit"), trayIconMenu);
     connect(quitAction, &QAction::triggered, qApp, &QApplication::quit);
-    newTrayIconMenu->addAction(quitAction);
+    trayIconMenu->addAction(quitAction);
+}
 
-    trayIcon->setContextMenu(newTrayIconMenu);
+void MainWindow::updateTrayMenu() {
+    if (!trayIcon) return;
+
+    // The menu is exported over D-Bus by the StatusNotifier, so only entries that actually changed are touched
+    int unreadCount = m_lastUnreadCount;
+    bool hasUnread = unreadCount > 0;
+    QString unreadTitle = tr("%1 Unread Notifications").arg(unreadCount);
+    if (m_trayUnreadMenu->title() != unreadTitle) m_trayUnreadMenu->setTitle(unreadTitle);
+    if (m_trayUnreadMenuAction->isVisible() != hasUnread) m_trayUnreadMenuAction->setVisible(hasUnread);
+    if (m_trayEmptyAction->isVisible() == hasUnread) m_trayEmptyAction->setVisible(!hasUnread);
+
+    QList<Notification> unreadNotifications;
+    if (hasUnread && notificationListWidget) {
+        unreadNotifications = notificationListWidget->getUnreadNotifications(m_trayUnreadLimit);
+    }
+
+    QSet<QString> wanted;
+    for (const Notification& n : unreadNotifications) {
+        wanted.insert(n.id);
+    }
+    for (auto it = m_trayItemActions.begin(); it != m_trayItemActions.end();) {
+        if (!wanted.contains(it.key())) {
+            m_trayUnreadMenu->removeAction(it.value());
+            delete it.value();
+            it = m_trayItemActions.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    if (trayIconMenu) {
-        trayIconMenu->deleteLater();
+    // Walk the wanted order against the menu, inserting or moving only the entries that are out of place
+    for (int i = 0; i < unreadNotifications.size(); ++i) {
+        const Notification& n = unreadNotifications.at(i);
+        QString label = QString("%1: %2").arg(n.repository, n.title);
+
+        QAction* itemAction = m_trayItemActions.value(n.id);
+        if (!itemAction) {
+            itemAction = new QAction(label, m_trayUnreadMenu);
+            QString id = n.id;
+            QString url = n.url;
+            connect(itemAction, &QAction::triggered, this, [this, url, id]() {
+                if (client) client->markAsRead(id);
+                m_engine->threadRead(id);
+                QString htmlUrl = GitHubClient::apiToHtmlUrl(url, id);
+                QDesktopServices::openUrl(QUrl(htmlUrl));
+
+                if (notificationListWidget) notificationListWidget->focusNotification(id);
+            });
+            m_trayItemActions.insert(n.id, itemAction);
+        } else if (itemAction->text() != label) {
+            itemAction->setText(label);
+        }
+
+        QList<QAction*> current = m_trayUnreadMenu->actions();
+        if (current.value(i) != itemAction) {
+            m_trayUnreadMenu->removeAction(itemAction);
+            m_trayUnreadMenu->insertAction(current.value(i, m_trayUnreadSeparator), itemAction);
+        }
     }
-    trayIconMenu = newTrayIconMenu;
 
     updateTrayToolTip();
 }
@@ -616,6 +833,9 @@ void MainWindow::updateTrayToolTip() {
     }
 
     parts << tr("Unread: %1").arg(m_lastUnreadCount);
+    if (m_engine->dispatcher()->queueDepth() > 0) {
+        parts << tr("Pending popups: %1").arg(m_engine->dispatcher()->queueDepth());
+    }
 
     QList<Notification> unreadNotifications =
         notificationListWidget ? notificationListWidget->getUnreadNotifications() : QList<Notification>();
@@ -634,8 +854,10 @@ void MainWindow::updateTrayToolTip() {
     if (m_lastCheckTime.isValid()) {
         parts << tr("Last Check: %1").arg(QLocale::system().toString(m_lastCheckTime, QLocale::ShortFormat));
 
-        if (refreshTimer && refreshTimer->isActive()) {
-            QDateTime nextCheck = m_lastCheckTime.addMSecs(refreshTimer->interval());
+        QDateTime nextCheck = m_pollScheduler->nextPollTime();
+        if (m_pollScheduler->isPaused()) {
+            parts << tr("Next Check: paused");
+        } else if (nextCheck.isValid()) {
             parts << tr("Next Check: %1").arg(QLocale::system().toString(nextCheck, QLocale::ShortFormat));
         }
     } else {
@@ -704,6 +926,7 @@ void MainWindow::createLoadingPage() {
 void MainWindow::ensureWindowActive() {
     showNormal();
     raise();
+    m_pollScheduler->noteActivity();
 
     if (QGuiApplication::platformName().startsWith(QLatin1String("wayland"), Qt::CaseInsensitive)) {
         QApplication::alert(this, 0);
@@ -735,7 +958,15 @@ void MainWindow::setupCentralWidget() {
 void MainWindow::setupNotificationList() {
     notificationListWidget = new NotificationListWidget(this);
     connect(notificationListWidget, &NotificationListWidget::countsChanged, this, &MainWindow::onListCountsChanged);
+    connect(notificationListWidget->store(), &NotificationStore::countsChanged, this,
+            &MainWindow::onStoreCountsChanged);
+    connect(notificationListWidget->store(), &NotificationStore::repositoriesChanged, this,
+            &MainWindow::updateRepoFilter);
     connect(notificationListWidget, &NotificationListWidget::statusMessage, this, &MainWindow::onListStatusMessage);
+    connect(notificationListWidget, &NotificationListWidget::repoFilterRequested, this, [this](const QString& repo) {
+        int index = repoFilterComboBox->findText(repo);
+        if (index >= 0) repoFilterComboBox->setCurrentIndex(index);
+    });
     connect(notificationListWidget, &NotificationListWidget::linkActivated, this, [this](const QUrl& url) {
         // Do nothing specific, link already opened. Maybe update status?
     });
@@ -756,18 +987,23 @@ void MainWindow::setupToolbar() {
     toolbar->addAction(refreshAction);
 
     filterComboBox = new QComboBox(this);
-    filterComboBox->addItem(tr("All Unread"));
+    auto addCountedFilter = [this](const QString& label, const QString& countLabel, const QString& reason) {
+        filterComboBox->addItem(label);
+        filterComboBox->setItemData(filterComboBox->count() - 1, reason, kFilterReasonRole);
+        filterComboBox->setItemData(filterComboBox->count() - 1, countLabel, kFilterCountLabelRole);
+    };
+    addCountedFilter(tr("All Unread"), tr("All Unread (%1)"), QString(""));
     filterComboBox->addItem(tr("All Read before Updated"));
     filterComboBox->addItem(tr("Updated recently"));
     filterComboBox->addItem(tr("All read"));
     filterComboBox->addItem(tr("All"));
-    filterComboBox->addItem(tr("Mentions (Unread)"));
+    addCountedFilter(tr("Mentions (Unread)"), tr("Mentions (%1 Unread)"), "mention");
     filterComboBox->addItem(tr("Mentions (All)"));
-    filterComboBox->addItem(tr("CI Activity (Unread)"));
+    addCountedFilter(tr("CI Activity (Unread)"), tr("CI Activity (%1 Unread)"), "ci_activity");
     filterComboBox->addItem(tr("CI Activity (All)"));
-    filterComboBox->addItem(tr("Review Requested (Unread)"));
+    addCountedFilter(tr("Review Requested (Unread)"), tr("Review Requested (%1 Unread)"), "review_requested");
     filterComboBox->addItem(tr("Review Requested (All)"));
-    filterComboBox->addItem(tr("Subscribed (Unread)"));
+    addCountedFilter(tr("Subscribed (Unread)"), tr("Subscribed (%1 Unread)"), "subscribed");
     filterComboBox->addItem(tr("Subscribed (All)"));
     connect(filterComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onFilterChanged);
     toolbar->addWidget(filterComboBox);
@@ -806,14 +1042,41 @@ void MainWindow::setupToolbar() {
     sortComboBox->addItem(tr("Type (Z-A)"));
     sortComboBox->addItem(tr("Last Read (Newest)"));
     sortComboBox->addItem(tr("Last Read (Oldest)"));
+    sortComboBox->addItem(tr("Repository, Reason, Updated"));
+    sortComboBox->addItem(tr("Custom..."));
     sortComboBox->setSizeAdjustPolicy(QComboBox::AdjustToContents);
-    connect(sortComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
-        if (notificationListWidget) {
-            notificationListWidget->setSortMode(index);
+    // activated, not currentIndexChanged, so picking "Custom..." again reopens the prompt
+    connect(sortComboBox, &QComboBox::activated, this, [this](int index) {
+        if (!notificationListWidget) return;
+        if (index == NotificationListWidget::SortCustom) {
+            bool ok = false;
+            QString spec = QInputDialog::getText(
+                this, tr("Custom Sort"),
+                tr("Sort keys, in order (repository, title, type, reason, updated, lastread).\n"
+                   "Prefix a key with '-' to sort it descending:"),
+                QLineEdit::Normal, SettingsDialog::getCustomSortKeys(), &ok);
+            if (ok && !NotificationSorter::parseCriteria(spec).isEmpty()) {
+                SettingsDialog::setCustomSortKeys(spec);
+                notificationListWidget->setCustomSortKeys(spec);
+            }
         }
+        notificationListWidget->setSortMode(index);
     });
     toolbar->addWidget(sortComboBox);
 
+    QComboBox* groupComboBox = new QComboBox(this);
+    groupComboBox->addItem(tr("No Grouping"));
+    groupComboBox->addItem(tr("Group by Repository"));
+    groupComboBox->addItem(tr("Group by Reason"));
+    groupComboBox->addItem(tr("Group by Type"));
+    groupComboBox->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    connect(groupComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        if (notificationListWidget) {
+            notificationListWidget->setGroupMode(index);
+        }
+    });
+    toolbar->addWidget(groupComboBox);
+
     toolbar->addSeparator();
 
     selectAllAction = new QAction(tr("Select All"), this);
@@ -853,17 +1116,33 @@ void MainWindow::setupToolbar() {
 }
 
 void MainWindow::setupPages() {
-    createErrorPage();
-    stackWidget->addWidget(errorPage);
+    // Only the loading page is shown on every start; the others are built when first needed
+    createLoadingPage();
+    stackWidget->addWidget(loadingPage);
+}
 
-    createLoginPage();
-    stackWidget->addWidget(loginPage);
+QWidget* MainWindow::ensureErrorPage() {
+    if (!errorPage) {
+        createErrorPage();
+        stackWidget->addWidget(errorPage);
+    }
+    return errorPage;
+}
 
-    createEmptyStatePage();
-    stackWidget->addWidget(emptyStatePage);
+QWidget* MainWindow::ensureLoginPage() {
+    if (!loginPage) {
+        createLoginPage();
+        stackWidget->addWidget(loginPage);
+    }
+    return loginPage;
+}
 
-    createLoadingPage();
-    stackWidget->addWidget(loadingPage);
+QWidget* MainWindow::ensureEmptyStatePage() {
+    if (!emptyStatePage) {
+        createEmptyStatePage();
+        stackWidget->addWidget(emptyStatePage);
+    }
+    return emptyStatePage;
 }
 
 void MainWindow::setupMenus() {
@@ -876,8 +1155,9 @@ void MainWindow::setupMenus() {
     KStandardAction::aboutApp(this, &MainWindow::showAboutDialog, actionCollection());
     QAction* notificationRulesAction =
         new QAction(themedIcon({QStringLiteral("view-list-details")}), tr("Notification &Rules..."), this);
-    connect(notificationRulesAction, &QAction::triggered, this, []() {
+    connect(notificationRulesAction, &QAction::triggered, this, [this]() {
         RulesDialog dialog;
+        dialog.setSimulationNotifications(notificationListWidget->allNotifications());
         dialog.exec();
     });
     actionCollection()->addAction(QStringLiteral("notification_rules"), notificationRulesAction);
@@ -903,15 +1183,37 @@ void MainWindow::setupMenus() {
     connect(repoListAction, &QAction::triggered, this, &MainWindow::showRepoListWindow);
     actionCollection()->addAction(QStringLiteral("repo_list"), repoListAction);
 
+    // Some 60 search actions sit under these, and most sessions never open them: fill each on first use
     KActionMenu* issuesMenu = new KActionMenu(tr("Issues"), this);
     actionCollection()->addAction(QStringLiteral("issues_menu"), issuesMenu);
+    populateWorkItemMenuOnShow(issuesMenu, 0);
 
     KActionMenu* prsMenu = new KActionMenu(tr("Pull Requests"), this);
     actionCollection()->addAction(QStringLiteral("prs_menu"), prsMenu);
+    populateWorkItemMenuOnShow(prsMenu, 1);
 
     KActionMenu* reposMenu = new KActionMenu(tr("Repositories"), this);
     actionCollection()->addAction(QStringLiteral("repos_menu"), reposMenu);
+    populateWorkItemMenuOnShow(reposMenu, 2);
+
+    QAction* aboutQtAction = new QAction(tr("About &Qt"), this);
+    connect(aboutQtAction, &QAction::triggered, qApp, &QApplication::aboutQt);
+    actionCollection()->addAction(QStringLiteral("about_qt"), aboutQtAction);
+
+    setupGUI(Default, ":/kgithub-notifyui.rc");
+}
 
+void MainWindow::populateWorkItemMenuOnShow(KActionMenu* menu, int endpointType) {
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(menu->menu(), &QMenu::aboutToShow, this, [this, menu, endpointType, connection]() {
+        disconnect(*connection);
+        populateWorkItemMenu(menu, endpointType);
+        // These actions missed setupGUI(), so the user's saved shortcuts are applied to them now
+        actionCollection()->readSettings();
+    });
+}
+
+void MainWindow::populateWorkItemMenu(KActionMenu* parentMenu, int endpointType) {
     struct Variant {
         QString name;
         QString actionId;
@@ -937,8 +1239,8 @@ void MainWindow::setupMenus() {
          "archived:true user:@me"},
         {tr("All (Unfiltered)"), "unfiltered", "involves:@me", "involves:@me", "user:@me"}};
 
-    auto createSubMenu = [&](KActionMenu* parentMenu, const QString& statusName, const QString& statusId,
-                             const QString& statusQuery, const QString& typeQuery, int endpointType) {
+    auto createSubMenu = [&](const QString& statusName, const QString& statusId, const QString& statusQuery,
+                             const QString& typeQuery) {
         KActionMenu* statusMenu = parentMenu;
         if (!statusName.isEmpty()) {
             statusMenu = new KActionMenu(statusName, this);
@@ -967,23 +1269,20 @@ void MainWindow::setupMenus() {
         }
     };
 
-    createSubMenu(issuesMenu, tr("Open"), "issues_open", "is:open", "is:issue", 0);
-    createSubMenu(issuesMenu, tr("Closed"), "issues_closed", "is:closed", "is:issue", 0);
-    createSubMenu(issuesMenu, tr("All Statuses"), "issues_all", "", "is:issue", 0);
-
-    createSubMenu(prsMenu, tr("Open"), "prs_open", "is:open", "is:pr", 1);
-    createSubMenu(prsMenu, tr("Closed"), "prs_closed", "is:closed", "is:pr", 1);
-    createSubMenu(prsMenu, tr("Merged"), "prs_merged", "is:merged", "is:pr", 1);
-    createSubMenu(prsMenu, tr("All Statuses"), "prs_all", "", "is:pr", 1);
-
-    createSubMenu(reposMenu, "", "repos", "", "", 2);
-
-    QAction* aboutQtAction = new QAction(tr("About &Qt"), this);
-    connect(aboutQtAction, &QAction::triggered, qApp, &QApplication::aboutQt);
-    actionCollection()->addAction(QStringLiteral("about_qt"), aboutQtAction);
-
-    setupGUI(Default, ":/kgithub-notifyui.rc");
+    if (endpointType == 0) {
+        createSubMenu(tr("Open"), "issues_open", "is:open", "is:issue");
+        createSubMenu(tr("Closed"), "issues_closed", "is:closed", "is:issue");
+        createSubMenu(tr("All Statuses"), "issues_all", "", "is:issue");
+    } else if (endpointType == 1) {
+        createSubMenu(tr("Open"), "prs_open", "is:open", "is:pr");
+        createSubMenu(tr("Closed"), "prs_closed", "is:closed", "is:pr");
+        createSubMenu(tr("Merged"), "prs_merged", "is:merged", "is:pr");
+        createSubMenu(tr("All Statuses"), "prs_all", "", "is:pr");
+    } else {
+        createSubMenu("", "repos", "", "");
+    }
 }
+
 void MainWindow::showWorkItems(const QString& title, int endpointType, const QString& query) {
     WorkItemWindow::EndpointType type =
         (endpointType == 0) ? WorkItemWindow::EndpointIssues : WorkItemWindow::EndpointRepositories;
@@ -1018,16 +1317,16 @@ void MainWindow::setupStatusBar() {
     statusBar->addPermanentWidget(desktopWarningButton);
     statusBar->addPermanentWidget(timerLabel);
 
-    refreshTimer = new QTimer(this);
     countdownTimer = new QTimer(this);
 
     connect(countdownTimer, &QTimer::timeout, this, &MainWindow::updateStatusBar);
+    connect(m_pollScheduler, &PollScheduler::scheduleChanged, this, &MainWindow::updateStatusBar);
     countdownTimer->start(1000);
 }
 
 void MainWindow::loadToken() {
-    tokenWatcher = new QFutureWatcher<QString>(this);
-    connect(tokenWatcher, &QFutureWatcher<QString>::finished, this, &MainWindow::onTokenLoaded);
+    tokenWatcher = new QFutureWatcher<WalletManager::Result>(this);
+    connect(tokenWatcher, &QFutureWatcher<WalletManager::Result>::finished, this, &MainWindow::onTokenLoaded);
     tokenWatcher->setFuture(SettingsDialog::getTokenAsync());
 }
 
@@ -1050,66 +1349,6 @@ QIcon MainWindow::themedIcon(const QStringList& names, const QString& fallbackRe
     return QApplication::style()->standardIcon(fallbackPixmap);
 }
 
-void MainWindow::sendNotification(const Notification& n) {
-    KNotification* notification = new KNotification("NewNotification");
-    notification->setComponentName(QStringLiteral("kgithub-notify"));
-    notification->setTitle(n.repository);
-
-    QString text = n.title;
-    if (!n.groupedNotifications.isEmpty()) {
-        text += tr("\n+ %1 Grouped Actions").arg(n.groupedNotifications.size());
-    }
-    notification->setText(text);
-
-    // Actions
-    auto action1 = notification->addAction(tr("Open in GitHub"));
-    connect(action1, &KNotificationAction::activated, this, [this, n]() {
-        QString htmlUrl = GitHubClient::apiToHtmlUrl(n.url, n.id);
-        QDesktopServices::openUrl(QUrl(htmlUrl));
-    });
-
-    auto action2 = notification->addAction(tr("Open kgithub-notify"));
-    connect(action2, &KNotificationAction::activated, this, [this, n]() {
-        if (notificationListWidget) notificationListWidget->focusNotification(n.id);
-        ensureWindowActive();
-    });
-
-    auto defaultAction = notification->addDefaultAction(tr("Open"));
-    connect(defaultAction, &KNotificationAction::activated, this, [this]() { this->ensureWindowActive(); });
-    connect(notification, &KNotification::closed, notification, &QObject::deleteLater);
-
-    notification->sendEvent();
-}
-
-void MainWindow::sendSummaryNotification(int count, const QList<Notification>& notifications) {
-    KNotification* notification = new KNotification("NewNotification");
-    notification->setComponentName(QStringLiteral("kgithub-notify"));
-    notification->setTitle(tr("%1 New Notifications").arg(count));
-
-    QString summary;
-    int limit = qMin(count, 5);
-    for (int i = 0; i < limit; ++i) {
-        summary += "- " + notifications[i].title + "\n";
-    }
-    if (count > limit) {
-        summary += tr("... and %1 more").arg(count - limit);
-    }
-    notification->setText(summary.trimmed());
-
-    // Actions
-    auto action1 = notification->addAction(tr("Open kgithub-notify"));
-    connect(action1, &KNotificationAction::activated, this, [this]() { this->ensureWindowActive(); });
-
-    auto defaultAction = notification->addDefaultAction(tr("Open"));
-    connect(defaultAction, &KNotificationAction::activated, this, [this]() {
-        this->showNormal();
-        this->activateWindow();
-    });
-    connect(notification, &KNotification::closed, notification, &QObject::deleteLater);
-
-    notification->sendEvent();
-}
-
 void MainWindow::updateTrayIconState(int unreadCount, int newNotifications,
                                      const QList<Notification>& newlyAddedNotifications) {
     if (unreadCount <= 0) {
@@ -1120,57 +1359,7 @@ void MainWindow::updateTrayIconState(int unreadCount, int newNotifications,
     }
 
     trayIcon->setIcon(QIcon(":/assets/icon-dotted.png"));
-    if (newNotifications > 0) {
-        int threshold = SettingsDialog::getSummaryThreshold();
-        int stepDelayMs = SettingsDialog::getNotificationDelayMs();
-        bool notifyRead = SettingsDialog::getNotifyRead();
-
-        QList<Notification> individualNotifications;
-        QList<Notification> summarizedNotifications;
-
-        for (const Notification& n : newlyAddedNotifications) {
-            if (!n.unread && !notifyRead) continue;
-
-            QString action = NotificationRuleEngine::evaluate(n);
-
-            if (action == "Mute") {
-                continue;
-            } else if (action == "AlwaysIndividual") {
-                individualNotifications.append(n);
-            } else if (action == "NeverIndividual") {
-                summarizedNotifications.append(n);
-            } else if (action == "AlwaysSummarize") {
-                summarizedNotifications.append(n);
-            } else {
-                // Default
-                summarizedNotifications.append(n);
-            }
-        }
-
-        // Send summarize notifications if they exceed the threshold or if they explicitly asked to summarize
-        bool hasAlwaysSummarize = false;
-        for (const Notification& n : summarizedNotifications) {
-            if (NotificationRuleEngine::evaluate(n) == "AlwaysSummarize" ||
-                NotificationRuleEngine::evaluate(n) == "NeverIndividual") {
-                hasAlwaysSummarize = true;
-                break;
-            }
-        }
-
-        if (summarizedNotifications.size() > threshold || (hasAlwaysSummarize && summarizedNotifications.size() > 0)) {
-            sendSummaryNotification(summarizedNotifications.size(), summarizedNotifications);
-        } else {
-            for (const Notification& n : summarizedNotifications) {
-                individualNotifications.append(n);
-            }
-        }
-
-        int delayMs = 0;
-        for (const Notification& n : individualNotifications) {
-            QTimer::singleShot(delayMs, this, [this, n]() { sendNotification(n); });
-            delayMs += stepDelayMs;
-        }
-    }
+    if (newNotifications > 0) m_engine->announce(newlyAddedNotifications);
     updateTrayMenu();
 }
 
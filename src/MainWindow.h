@@ -5,12 +5,14 @@
 #include <KXmlGuiWindow>
 #include <QDateTime>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QIcon>
 #include <QLabel>
 #include <QMenu>
 #include <QMessageBox>
 #include <QPointer>
 #include <QPushButton>
+#include <QSet>
 #include <QStackedWidget>
 #include <QStatusBar>
 #include <QStringList>
@@ -23,12 +25,16 @@
 #include "GitHubClient.h"
 #include "Notification.h"
 #include "NotificationListWidget.h"
+#include "WalletManager.h"
 
 class NotificationItemWidget;
 class QSpinBox;
 class QComboBox;
 class QLineEdit;
 class DebugWindow;
+class KActionMenu;
+class NotificationEngine;
+class PollScheduler;
 class RepoListWindow;
 class TrendingWindow;
 class NewIssueDialog;
@@ -51,10 +57,13 @@ class MainWindow : public KXmlGuiWindow {
     void onTrayIconActivated(QSystemTrayIcon::ActivationReason reason);
     void onTrayMessageClicked();
     void showSettings();
+    void onSettingChanged(const QString& key);
     void onLoadingStarted();
     void onAuthNotificationSettingsClicked();
     void dismissAllNotifications();
     void onTokenLoaded();
+    void onNotificationsUnchanged();
+    void saveSnapshot();
 
     // Toolbar slots
     void onRefreshClicked();
@@ -76,19 +85,27 @@ class MainWindow : public KXmlGuiWindow {
     // From ListWidget
     void onListCountsChanged(int total, int unread, int newCount, const QList<Notification>& newItems);
     void onListStatusMessage(const QString& message);
+    void onStoreCountsChanged(int total, int unread);
+    void updateRepoFilter();
 
    protected:
     void closeEvent(QCloseEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
 
    private:
     // Helpers
     void createTrayIcon();
+    void buildTrayMenu();
     void updateTrayMenu();
     void updateTrayToolTip();
     void createErrorPage();
     void createLoginPage();
     void createEmptyStatePage();
     void createLoadingPage();
+    QWidget* ensureErrorPage();
+    QWidget* ensureLoginPage();
+    QWidget* ensureEmptyStatePage();
     void ensureWindowActive();
     void setupWindow();
     void setupCentralWidget();
@@ -96,13 +113,17 @@ class MainWindow : public KXmlGuiWindow {
     void setupToolbar();
     void setupPages();
     void setupMenus();
+    void populateWorkItemMenuOnShow(KActionMenu* menu, int endpointType);
+    void populateWorkItemMenu(KActionMenu* parentMenu, int endpointType);
     void setupStatusBar();
+    void restoreSnapshot();
+    void enterTrayResidentMode();
+    void leaveTrayResidentMode();
     void loadToken();
     QIcon themedIcon(const QStringList& names, const QString& fallbackResource = QString(),
                      QStyle::StandardPixmap fallbackPixmap = QStyle::SP_FileIcon) const;
-    void sendNotification(const Notification& n);
-    void sendSummaryNotification(int count, const QList<Notification>& notifications);
     void updateSelectionComboBox();
+    void updateFilterCounts();
     void updateTrayIconState(int unreadCount, int newNotifications, const QList<Notification>& newlyAddedNotifications);
 
     // Member Variables
@@ -130,7 +151,7 @@ class MainWindow : public KXmlGuiWindow {
     QAction* dismissSelectedAction;
     QAction* openSelectedAction;
 
-    // UI components
+    // UI components; all pages but the loading page are created on first use
     QStackedWidget* stackWidget;
     QWidget* errorPage;
     QLabel* errorLabel;
@@ -149,17 +170,35 @@ class MainWindow : public KXmlGuiWindow {
     QString desktopWarningMessage;
     QLabel* countLabel;
     QLabel* timerLabel;
-    QTimer* refreshTimer;
+    PollScheduler* m_pollScheduler;  // Owned by m_engine
     QTimer* countdownTimer;
     QLabel* statusLabel;
 
-    QFutureWatcher<QString>* tokenWatcher;
+    QFutureWatcher<WalletManager::Result>* tokenWatcher;
     QString m_loadedToken;
 
     QDateTime m_lastCheckTime;
 
+    // Warm start: the saved list is shown until the first fetch, which reuses the saved validators
+    QTimer* m_snapshotTimer;
+    QByteArray m_snapshotLastModified;
+    QString m_snapshotNextPageUrl;
+
+    // Tray-resident mode: once the window has been hidden for a while, everything that only serves drawing it
+    // is released and rebuilt on the next show
+    QTimer* m_trayResidentTimer;
+    bool m_trayResident;
+
     // Cache for tray menu
     int m_lastUnreadCount;
+    int m_trayUnreadLimit;
+    QMenu* m_trayUnreadMenu = nullptr;
+    QAction* m_trayUnreadMenuAction = nullptr;
+    QAction* m_trayUnreadSeparator = nullptr;
+    QAction* m_trayEmptyAction = nullptr;
+    QHash<QString, QAction*> m_trayItemActions;  // Thread id -> entry in m_trayUnreadMenu
+
+    NotificationEngine* m_engine;
     QList<Notification> m_lastUnreadNotifications;  // Only for tray menu display if needed, or rely on widget
 };
 
@@ -0,0 +1,183 @@
+#include "NotificationDaemon.h"
+
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "AppSettings.h"
+#include "GitHubClient.h"
+#include "KnownNotificationStore.h"
+#include "NotificationEngine.h"
+#include "NotificationStore.h"
+#include "NotificationViewPipeline.h"
+#include "PollScheduler.h"
+
+NotificationDaemon::NotificationDaemon(GitHubClient* client, TokenLoader tokenLoader, QObject* parent)
+    : QObject(parent),
+      m_client(client),
+      m_engine(new NotificationEngine(this)),
+      m_store(new NotificationStore(this)),
+      m_tokenLoader(std::move(tokenLoader)),
+      m_tokenWatcher(nullptr),
+      m_hasToken(false),
+      m_status(tr("Loading token")) {
+    AppSettings* settings = AppSettings::instance();
+    settings->setWatchFile(true);
+
+    m_knownStore = new KnownNotificationStore(
+        settings->notifyOnce() ? KnownNotificationStore::defaultLogPath() : QString(), this);
+    m_knownStore->load(settings->knownNotificationRetentionDays());
+
+    connect(m_engine, &NotificationEngine::popupActivated, this, [this](const QString& id) {
+        if (!id.isEmpty()) emit notificationActivated(id);
+    });
+
+    connect(m_store, &NotificationStore::countsChanged, this, &NotificationDaemon::countsChanged);
+
+    connect(m_client, &GitHubClient::notificationsReceived, this, &NotificationDaemon::onNotificationsReceived);
+    connect(m_client, &GitHubClient::notificationsUnchanged, this, [this]() { setStatus(QStringLiteral("Ok")); });
+    connect(m_client, &GitHubClient::errorOccurred, this, &NotificationDaemon::setStatus);
+    connect(m_client, &GitHubClient::authError, this,
+            [this](const QString& message) { setStatus(tr("Authentication error: %1").arg(message)); });
+
+    // Polling starts with the first token, so a daemon without one does not keep reporting auth errors
+    loadToken();
+}
+
+QString NotificationDaemon::serviceName() { return QStringLiteral("com.arran4.kgithub_notify"); }
+
+QString NotificationDaemon::objectPath() { return QStringLiteral("/Notifications"); }
+
+bool NotificationDaemon::registerOnBus() {
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (!bus.isConnected()) {
+        qWarning() << "No D-Bus session bus:" << bus.lastError().message();
+        return false;
+    }
+    if (!bus.registerService(serviceName())) {
+        qWarning() << "Could not register" << serviceName() << "- is another daemon running?"
+                   << bus.lastError().message();
+        return false;
+    }
+    return bus.registerObject(objectPath(), this,
+                              QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportScriptableSignals);
+}
+
+int NotificationDaemon::totalCount() const { return m_store->totalCount(); }
+
+int NotificationDaemon::unreadCount() const { return m_store->unreadCount(); }
+
+QStringList NotificationDaemon::repositories() const { return m_store->repositories(); }
+
+QString NotificationDaemon::listNotifications(int filterMode, const QString& repository,
+                                              const QString& search) const {
+    NotificationViewParams params;
+    params.filterMode = filterMode;
+    params.sortKeys = NotificationSorter::parseCriteria(QStringLiteral("-updated"));
+    params.repoFilter = repository;
+    params.searchFilter = search;
+
+    // Small enough to compute on the spot; the pipeline's worker is only worth it for a list being scrolled
+    NotificationSorter sorter;
+    NotificationView view = NotificationViewPipeline::compute(m_store->notifications(), params, sorter);
+
+    QJsonArray array;
+    for (const QString& id : std::as_const(view.ids)) {
+        if (view.hidden.contains(id)) continue;
+        const Notification* n = m_store->find(id);
+        if (n) array.append(n->toJson());
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+
+QString NotificationDaemon::notification(const QString& id) const {
+    const Notification* n = m_store->find(id);
+    if (!n) return QString();
+    return QString::fromUtf8(QJsonDocument(n->toJson()).toJson(QJsonDocument::Compact));
+}
+
+bool NotificationDaemon::markAsRead(const QString& id) {
+    if (!m_store->contains(id)) return false;
+    m_client->markAsRead(id);
+    m_engine->threadRead(id);
+    m_store->setUnread(id, false);
+    emit notificationsChanged();
+    return true;
+}
+
+bool NotificationDaemon::markAsDone(const QString& id) {
+    if (!m_store->contains(id)) return false;
+    m_client->markAsDone(id);
+    m_engine->threadRead(id);
+    m_store->removeNotification(id);
+    emit notificationsChanged();
+    return true;
+}
+
+void NotificationDaemon::refresh() {
+    if (!m_hasToken) return;
+    m_client->checkNotifications();
+    m_engine->pollScheduler()->notePoll();
+}
+
+void NotificationDaemon::reloadToken() {
+    WalletManager::clearCache();
+    loadToken();
+}
+
+void NotificationDaemon::loadToken() {
+    if (m_tokenWatcher && m_tokenWatcher->isRunning()) return;
+    if (!m_tokenWatcher) {
+        m_tokenWatcher = new QFutureWatcher<WalletManager::Result>(this);
+        connect(m_tokenWatcher, &QFutureWatcher<WalletManager::Result>::finished, this,
+                &NotificationDaemon::onTokenLoaded);
+    }
+    m_tokenWatcher->setFuture(m_tokenLoader());
+}
+
+void NotificationDaemon::onTokenLoaded() {
+    WalletManager::Result result = m_tokenWatcher->result();
+    m_hasToken = result.ok() && !result.token.isEmpty();
+    if (!result.ok()) {
+        setStatus(tr("Could not read the token: %1").arg(result.errorString()));
+        return;
+    }
+    if (result.token.isEmpty()) {
+        setStatus(tr("No token configured; set one in the application's settings"));
+        return;
+    }
+
+    m_client->setToken(result.token);
+    m_engine->setClient(m_client);
+    refresh();
+}
+
+void NotificationDaemon::onNotificationsReceived(const QList<Notification>& notifications, bool append,
+                                                 bool hasMore) {
+    setStatus(QStringLiteral("Ok"));
+
+    QList<Notification> newItems;
+    const QList<Notification> visible = m_engine->ingest(notifications, append);
+    for (const Notification& n : visible) {
+        if (m_knownStore->insert(n.id)) newItems.append(n);
+    }
+
+    if (append) {
+        m_store->appendNotifications(visible);
+    } else {
+        m_store->setNotifications(visible);
+    }
+    if (!newItems.isEmpty() && m_store->unreadCount() > 0) m_engine->announce(newItems);
+    emit notificationsChanged();
+
+    // Without a list to scroll, only "get all" has a reason to page
+    if (hasMore && AppSettings::instance()->dataOption() == AppSettings::GetAll) m_client->loadMore();
+}
+
+void NotificationDaemon::setStatus(const QString& status) {
+    if (status == m_status) return;
+    m_status = status;
+    emit statusChanged(status);
+}
@@ -0,0 +1,81 @@
+#ifndef NOTIFICATIONDAEMON_H
+#define NOTIFICATIONDAEMON_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+#include "Notification.h"
+#include "WalletManager.h"
+
+class GitHubClient;
+class KnownNotificationStore;
+class NotificationEngine;
+class NotificationStore;
+
+// The window's NotificationEngine without the window, for `--daemon`: the client and a notification store,
+// with the notifications offered on the session bus to panels, scripts and thin front ends.
+//
+// The object is exported as com.arran4.kgithub_notify on /Notifications. Notifications are returned as JSON
+// arrays of the same objects the raw JSON view shows, so callers need no D-Bus type registration. Filter modes
+// are those of the window's filter box (0 all unread, 3 all read, 4 all, ...).
+class NotificationDaemon : public QObject {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.arran4.kgithub_notify.Notifications")
+   public:
+    // Called for the first token and on reloadToken(); tests pass one that never opens the wallet
+    using TokenLoader = std::function<QFuture<WalletManager::Result>()>;
+
+    explicit NotificationDaemon(GitHubClient* client, TokenLoader tokenLoader = &WalletManager::loadTokenAsync,
+                                QObject* parent = nullptr);
+
+    static QString serviceName();
+    static QString objectPath();
+    // Claims the bus name and exports the interface; false if it is taken (another daemon runs) or no bus
+    bool registerOnBus();
+
+   public slots:
+    Q_SCRIPTABLE int totalCount() const;
+    Q_SCRIPTABLE int unreadCount() const;
+    Q_SCRIPTABLE QStringList repositories() const;
+    // Newest first. An empty repository or search matches everything.
+    Q_SCRIPTABLE QString listNotifications(int filterMode, const QString& repository, const QString& search) const;
+    // The notification as a JSON object, or an empty string if it is not loaded
+    Q_SCRIPTABLE QString notification(const QString& id) const;
+    // Both return false for ids that are not loaded
+    Q_SCRIPTABLE bool markAsRead(const QString& id);
+    Q_SCRIPTABLE bool markAsDone(const QString& id);
+    Q_SCRIPTABLE void refresh();
+    // For front ends that changed the token in the wallet
+    Q_SCRIPTABLE void reloadToken();
+    // "Ok", or what is keeping notifications from being fetched
+    Q_SCRIPTABLE QString status() const { return m_status; }
+
+   signals:
+    Q_SCRIPTABLE void countsChanged(int total, int unread);
+    Q_SCRIPTABLE void notificationsChanged();
+    Q_SCRIPTABLE void statusChanged(const QString& status);
+    // The default action of a popup was used; a front end may want to show the thread
+    Q_SCRIPTABLE void notificationActivated(const QString& id);
+
+   private slots:
+    void onTokenLoaded();
+    void onNotificationsReceived(const QList<Notification>& notifications, bool append, bool hasMore);
+
+   private:
+    void loadToken();
+    void setStatus(const QString& status);
+
+    GitHubClient* m_client;
+    NotificationEngine* m_engine;
+    NotificationStore* m_store;
+    KnownNotificationStore* m_knownStore;
+    TokenLoader m_tokenLoader;
+    QFutureWatcher<WalletManager::Result>* m_tokenWatcher;
+    bool m_hasToken;
+    QString m_status;
+};
+
+#endif  // NOTIFICATIONDAEMON_H
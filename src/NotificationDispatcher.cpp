@@ -0,0 +1,119 @@
+#include "NotificationDispatcher.h"
+
+#include <QDebug>
+#include <cmath>
+
+NotificationDispatcher::NotificationDispatcher(QObject* parent)
+    : QObject(parent),
+      m_timer(new QTimer(this)),
+      m_lastRefillMs(0),
+      m_tokens(3),
+      m_intervalMs(1000),
+      m_burst(3),
+      m_maxQueue(50),
+      m_coalesceThreshold(5),
+      m_dropped(0),
+      m_cancelled(0),
+      m_coalesced(0) {
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &NotificationDispatcher::onTimeout);
+    m_clock.start();
+}
+
+void NotificationDispatcher::setRate(int intervalMs, int burst) {
+    refill();
+    m_intervalMs = qMax(1, intervalMs);
+    m_burst = qMax(1, burst);
+    m_tokens = qMin(m_tokens, double(m_burst));
+}
+
+void NotificationDispatcher::enqueue(const Notification& n) {
+    bool replaced = false;
+    for (Notification& queued : m_queue) {
+        if (queued.id == n.id) {
+            // A newer event on the same thread supersedes the one still waiting
+            queued = n;
+            replaced = true;
+            break;
+        }
+    }
+
+    if (!replaced) {
+        m_queue.append(n);
+        if (m_queue.size() > m_maxQueue) {
+            m_queue.removeFirst();
+            m_dropped++;
+            qDebug() << "Notification queue full, dropped the oldest popup (" << m_dropped << "so far)";
+        }
+    }
+
+    emit queueDepthChanged(m_queue.size());
+    if (!m_timer->isActive()) {
+        m_timer->start(0);
+    }
+}
+
+bool NotificationDispatcher::threadRead(const QString& id) {
+    for (int i = 0; i < m_queue.size(); ++i) {
+        if (m_queue.at(i).id == id && m_queue.at(i).unread) {
+            m_queue.removeAt(i);
+            m_cancelled++;
+            emit queueDepthChanged(m_queue.size());
+            return true;
+        }
+    }
+    return false;
+}
+
+void NotificationDispatcher::clear() {
+    m_timer->stop();
+    m_cancelled += m_queue.size();
+    m_queue.clear();
+    emit queueDepthChanged(0);
+}
+
+void NotificationDispatcher::onTimeout() {
+    refill();
+    while (!m_queue.isEmpty() && m_tokens >= 1.0) {
+        m_tokens -= 1.0;
+        dispatchOne();
+    }
+    emit queueDepthChanged(m_queue.size());
+    scheduleNext();
+}
+
+void NotificationDispatcher::refill() {
+    qint64 now = m_clock.elapsed();
+    m_tokens = qMin(double(m_burst), m_tokens + double(now - m_lastRefillMs) / m_intervalMs);
+    m_lastRefillMs = now;
+}
+
+void NotificationDispatcher::dispatchOne() {
+    Notification head = m_queue.takeFirst();
+
+    if (m_queue.size() >= m_coalesceThreshold) {
+        QList<Notification> group{head};
+        for (auto it = m_queue.begin(); it != m_queue.end();) {
+            if (it->repository == head.repository) {
+                group.append(*it);
+                it = m_queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (group.size() > 1) {
+            m_coalesced += group.size() - 1;
+            emit summaryReady(group);
+            return;
+        }
+    }
+
+    emit notificationReady(head);
+}
+
+void NotificationDispatcher::scheduleNext() {
+    if (m_queue.isEmpty()) return;
+
+    int waitMs = m_tokens >= 1.0 ? 0 : int(std::ceil((1.0 - m_tokens) * m_intervalMs));
+    m_timer->start(waitMs);
+}
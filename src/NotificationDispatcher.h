@@ -0,0 +1,63 @@
+#ifndef NOTIFICATIONDISPATCHER_H
+#define NOTIFICATIONDISPATCHER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+#include "Notification.h"
+
+// Paces desktop popups through a bounded queue.
+//
+// Popups are released by a token bucket: up to `burst` immediately, then one per interval. A thread that is
+// queued again replaces its earlier entry, entries for threads that are read before their turn are dropped,
+// and once the backlog passes the coalescing threshold the head entry is released together with every other
+// queued entry of the same repository as one summary. When the queue is full the oldest entry is dropped.
+class NotificationDispatcher : public QObject {
+    Q_OBJECT
+   public:
+    explicit NotificationDispatcher(QObject* parent = nullptr);
+
+    void setRate(int intervalMs, int burst);
+    void setMaxQueue(int maxQueue) { m_maxQueue = qMax(1, maxQueue); }
+    void setCoalesceThreshold(int backlog) { m_coalesceThreshold = qMax(1, backlog); }
+
+    void enqueue(const Notification& n);
+    // Drops the thread's entry if it was queued as unread; returns true if one was dropped
+    bool threadRead(const QString& id);
+    void clear();
+
+    int queueDepth() const { return m_queue.size(); }
+    int droppedCount() const { return m_dropped; }
+    int cancelledCount() const { return m_cancelled; }
+    int coalescedCount() const { return m_coalesced; }
+
+   signals:
+    void notificationReady(const Notification& n);
+    void summaryReady(const QList<Notification>& notifications);
+    void queueDepthChanged(int depth);
+
+   private slots:
+    void onTimeout();
+
+   private:
+    void refill();
+    void dispatchOne();
+    void scheduleNext();
+
+    QList<Notification> m_queue;
+    QTimer* m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastRefillMs;
+    double m_tokens;
+    int m_intervalMs;
+    int m_burst;
+    int m_maxQueue;
+    int m_coalesceThreshold;
+    int m_dropped;
+    int m_cancelled;
+    int m_coalesced;
+};
+
+#endif  // NOTIFICATIONDISPATCHER_H
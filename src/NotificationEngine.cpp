@@ -0,0 +1,274 @@
+#include "NotificationEngine.h"
+
+#include <KNotification>
+#include <QDBusConnection>
+#include <QDebug>
+#include <QDesktopServices>
+#include <QNetworkInformation>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+#include <limits>
+
+#include "AppSettings.h"
+#include "GitHubClient.h"
+#include "NotificationDispatcher.h"
+#include "PollScheduler.h"
+
+namespace {
+// Popups shown back to back before the configured delay applies between them
+const int kPopupBurst = 3;
+const int kStatsFlushDelayMs = 5 * 60 * 1000;
+
+int calculateSafeInterval(int minutes) {
+    if (minutes <= 0) minutes = 1;  // Minimum 1 minute
+    qint64 msec = static_cast<qint64>(minutes) * 60 * 1000;
+    if (msec > std::numeric_limits<int>::max()) {
+        return std::numeric_limits<int>::max();
+    }
+    return static_cast<int>(msec);
+}
+}  // namespace
+
+NotificationEngine::NotificationEngine(QObject* parent)
+    : QObject(parent),
+      m_client(nullptr),
+      m_pollScheduler(new PollScheduler(this)),
+      m_dispatcher(new NotificationDispatcher(this)),
+      m_offerOpenApp(false),
+      m_statsFlushTimer(new QTimer(this)) {
+    AppSettings* settings = AppSettings::instance();
+    connect(settings, &AppSettings::valueChanged, this, &NotificationEngine::onSettingChanged);
+
+    m_dispatcher->setRate(settings->notificationDelayMs(), kPopupBurst);
+    connect(m_dispatcher, &NotificationDispatcher::notificationReady, this, &NotificationEngine::sendPopup);
+    connect(m_dispatcher, &NotificationDispatcher::summaryReady, this, &NotificationEngine::sendSummaryPopup);
+
+    m_pollScheduler->setBaseInterval(calculateSafeInterval(settings->interval()));
+    setupPollPauses();
+
+    m_statsFlushTimer->setSingleShot(true);
+    m_statsFlushTimer->setInterval(kStatsFlushDelayMs);
+    connect(m_statsFlushTimer, &QTimer::timeout, this, []() { NotificationRuleEngine::flushStats(); });
+}
+
+NotificationEngine::~NotificationEngine() { NotificationRuleEngine::flushStats(); }
+
+void NotificationEngine::setClient(GitHubClient* client) {
+    if (!client || client == m_client) return;
+    m_client = client;
+
+    // Forgetting the thread lets the next poll that still lists it try again
+    connect(client, &GitHubClient::triageFailed, this, [this](const QString& id) { m_triagedThreads.remove(id); });
+    connect(client, &GitHubClient::notificationsUnchanged, m_pollScheduler,
+            [this]() { m_pollScheduler->reportResult(PollScheduler::Unchanged); });
+    connect(client, &GitHubClient::notificationsFailed, m_pollScheduler,
+            [this]() { m_pollScheduler->reportResult(PollScheduler::Failed); });
+    connect(client, &GitHubClient::pollHintsReceived, m_pollScheduler,
+            [this](int pollIntervalSecs, int rateLimitRemaining, qint64 rateLimitReset) {
+                if (pollIntervalSecs >= 0) m_pollScheduler->setServerMinimum(pollIntervalSecs);
+                m_pollScheduler->setRateLimit(rateLimitRemaining, rateLimitReset);
+            });
+
+    connect(m_pollScheduler, &PollScheduler::pollRequested, client, &GitHubClient::pollNotifications);
+    m_pollScheduler->start();
+}
+
+QList<Notification> NotificationEngine::ingest(const QList<Notification>& notifications, bool append) {
+    if (!append) m_pollScheduler->reportResult(PollScheduler::Changed);
+
+    const QList<RuleDecision> decisions = NotificationRuleEngine::evaluateBatch(notifications);
+    if (!append) {
+        m_ingestDecisions.clear();
+        m_mutedThreads.clear();
+    }
+    // Only a cap: a cleared entry at worst repeats an idempotent server call
+    if (m_triagedThreads.size() > 5000) m_triagedThreads.clear();
+
+    QList<Notification> visible;
+    visible.reserve(notifications.size());
+    QStringList markRead;
+    QStringList markDone;
+    QStringList unsubscribe;
+
+    for (int i = 0; i < notifications.size(); ++i) {
+        const Notification& n = notifications.at(i);
+        const RuleDecision& decision = decisions.at(i);
+        m_ingestDecisions.insert(n.id, decision);
+        // Read elsewhere (e.g. on github.com) while its popup was still waiting
+        if (!n.unread) m_dispatcher->threadRead(n.id);
+
+        if (!decision.serverAction.isEmpty() || decision.unsubscribe) {
+            // Compared by update time so a thread that is active again is handled again, but only once per update
+            auto triaged = m_triagedThreads.constFind(n.id);
+            if (triaged == m_triagedThreads.constEnd() || triaged.value() != n.updatedAt) {
+                m_triagedThreads.insert(n.id, n.updatedAt);
+                if (decision.serverAction == "MarkDone") {
+                    markDone << n.id;
+                } else if (decision.serverAction == "MarkRead" && n.unread) {
+                    markRead << n.id;
+                }
+                if (decision.unsubscribe) unsubscribe << n.id;
+            }
+        }
+
+        // Hidden threads never reach the list, so they are neither rendered nor hydrated
+        if (decision.hideFromList) continue;
+        if (decision.action == "Mute") m_mutedThreads.insert(n.id);
+        visible.append(n);
+    }
+
+    if (m_client && (!markRead.isEmpty() || !markDone.isEmpty() || !unsubscribe.isEmpty())) {
+        m_client->triageThreads(markRead, markDone, unsubscribe);
+    }
+    if (!m_statsFlushTimer->isActive()) m_statsFlushTimer->start();
+    return visible;
+}
+
+void NotificationEngine::announce(const QList<Notification>& newItems) {
+    bool notifyRead = AppSettings::instance()->notifyRead();
+
+    QList<Notification> candidates;
+    for (const Notification& n : newItems) {
+        if (!n.unread && !notifyRead) continue;
+        candidates.append(n);
+    }
+
+    // Decisions were made as the notifications arrived; only ones that came in some other way are evaluated now
+    QList<Notification> unevaluated;
+    for (const Notification& n : candidates) {
+        if (!m_ingestDecisions.contains(n.id)) unevaluated.append(n);
+    }
+    const QList<RuleDecision> lateDecisions = NotificationRuleEngine::evaluateBatch(unevaluated);
+    for (int i = 0; i < unevaluated.size(); ++i) {
+        m_ingestDecisions.insert(unevaluated.at(i).id, lateDecisions.at(i));
+    }
+
+    QList<Notification> individualNotifications;
+    QList<Notification> summarizedNotifications;
+    // Send summarize notifications if they exceed the threshold or if they explicitly asked to summarize
+    bool hasAlwaysSummarize = false;
+
+    for (const Notification& n : std::as_const(candidates)) {
+        QString action = m_ingestDecisions.value(n.id).action;
+
+        if (action == "Mute") {
+            continue;
+        } else if (action == "AlwaysIndividual") {
+            individualNotifications.append(n);
+        } else if (action == "NeverIndividual" || action == "AlwaysSummarize") {
+            summarizedNotifications.append(n);
+            hasAlwaysSummarize = true;
+        } else {
+            // Default
+            summarizedNotifications.append(n);
+        }
+    }
+
+    int threshold = AppSettings::instance()->summaryThreshold();
+    if (summarizedNotifications.size() > threshold || (hasAlwaysSummarize && !summarizedNotifications.isEmpty())) {
+        sendSummaryPopup(summarizedNotifications);
+    } else {
+        individualNotifications.append(summarizedNotifications);
+    }
+
+    // The dispatcher paces these and folds them into summaries if a backlog builds up
+    for (const Notification& n : std::as_const(individualNotifications)) {
+        m_dispatcher->enqueue(n);
+    }
+}
+
+void NotificationEngine::threadRead(const QString& id) { m_dispatcher->threadRead(id); }
+
+void NotificationEngine::sendPopup(const Notification& n) {
+    KNotification* notification = new KNotification("NewNotification");
+    notification->setComponentName(QStringLiteral("kgithub-notify"));
+    notification->setTitle(n.repository);
+
+    QString text = n.title;
+    if (!n.groupedNotifications.isEmpty()) {
+        text += tr("\n+ %1 Grouped Actions").arg(n.groupedNotifications.size());
+    }
+    notification->setText(text);
+
+    // Actions
+    QString htmlUrl = GitHubClient::apiToHtmlUrl(n.url, n.id);
+    auto openInGitHub = notification->addAction(tr("Open in GitHub"));
+    connect(openInGitHub, &KNotificationAction::activated, this,
+            [htmlUrl]() { QDesktopServices::openUrl(QUrl(htmlUrl)); });
+
+    QString id = n.id;
+    if (m_offerOpenApp) {
+        auto openApp = notification->addAction(tr("Open kgithub-notify"));
+        connect(openApp, &KNotificationAction::activated, this, [this, id]() { emit popupActivated(id); });
+    }
+
+    auto defaultAction = notification->addDefaultAction(tr("Open"));
+    connect(defaultAction, &KNotificationAction::activated, this, [this, id]() { emit popupActivated(id); });
+    connect(notification, &KNotification::closed, notification, &QObject::deleteLater);
+
+    notification->sendEvent();
+}
+
+void NotificationEngine::sendSummaryPopup(const QList<Notification>& notifications) {
+    int count = notifications.size();
+    KNotification* notification = new KNotification("NewNotification");
+    notification->setComponentName(QStringLiteral("kgithub-notify"));
+    notification->setTitle(tr("%1 New Notifications").arg(count));
+
+    QString summary;
+    int limit = qMin(count, 5);
+    for (int i = 0; i < limit; ++i) {
+        summary += "- " + notifications[i].title + "\n";
+    }
+    if (count > limit) {
+        summary += tr("... and %1 more").arg(count - limit);
+    }
+    notification->setText(summary.trimmed());
+
+    // Actions
+    if (m_offerOpenApp) {
+        auto openApp = notification->addAction(tr("Open kgithub-notify"));
+        connect(openApp, &KNotificationAction::activated, this, [this]() { emit popupActivated(QString()); });
+    }
+
+    auto defaultAction = notification->addDefaultAction(tr("Open"));
+    connect(defaultAction, &KNotificationAction::activated, this, [this]() { emit popupActivated(QString()); });
+    connect(notification, &KNotification::closed, notification, &QObject::deleteLater);
+
+    notification->sendEvent();
+}
+
+void NotificationEngine::onSettingChanged(const QString& key) {
+    if (key == "interval") {
+        m_pollScheduler->setBaseInterval(calculateSafeInterval(AppSettings::instance()->interval()));
+    } else if (key == "notificationDelayMs") {
+        m_dispatcher->setRate(AppSettings::instance()->notificationDelayMs(), kPopupBurst);
+    }
+}
+
+void NotificationEngine::setupPollPauses() {
+    if (QNetworkInformation::loadBackendByFeatures(QNetworkInformation::Feature::Reachability)) {
+        QNetworkInformation* info = QNetworkInformation::instance();
+        auto applyReachability = [this](QNetworkInformation::Reachability reachability) {
+            // Unknown is what backends report when they cannot tell, so only an explicit disconnect pauses
+            m_pollScheduler->setPaused(PollScheduler::Offline,
+                                       reachability == QNetworkInformation::Reachability::Disconnected);
+        };
+        connect(info, &QNetworkInformation::reachabilityChanged, this, applyReachability);
+        applyReachability(info->reachability());
+    } else {
+        qDebug() << "No network information backend, polling regardless of connectivity";
+    }
+
+    // Covers both an explicit lock and the session going idle
+    QDBusConnection::sessionBus().connect(
+        QStringLiteral("org.freedesktop.ScreenSaver"), QStringLiteral("/ScreenSaver"),
+        QStringLiteral("org.freedesktop.ScreenSaver"), QStringLiteral("ActiveChanged"), this,
+        SLOT(onScreenSaverActiveChanged(bool)));
+}
+
+void NotificationEngine::onScreenSaverActiveChanged(bool active) {
+    qDebug() << "Screen saver" << (active ? "active, pausing polls" : "inactive, resuming polls");
+    m_pollScheduler->setPaused(PollScheduler::SessionLocked, active);
+}
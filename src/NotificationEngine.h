@@ -0,0 +1,74 @@
+#ifndef NOTIFICATIONENGINE_H
+#define NOTIFICATIONENGINE_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+#include "Notification.h"
+#include "NotificationRuleEngine.h"
+
+class GitHubClient;
+class NotificationDispatcher;
+class PollScheduler;
+class QTimer;
+
+// What the window and the `--daemon` mode share between a poll and a popup, with no widgets involved:
+// the poll schedule and its offline/screen-lock pauses, ingest-time rule decisions with server-side triage of
+// muted threads, and the rule-driven popups paced by the dispatcher.
+//
+// Owners feed it every page the client delivers through ingest() and list what it returns, then hand the
+// threads they have not seen before to announce(). What "Open" on a popup does is up to the owner.
+class NotificationEngine : public QObject {
+    Q_OBJECT
+   public:
+    explicit NotificationEngine(QObject* parent = nullptr);
+    ~NotificationEngine() override;
+
+    // Ties the poll schedule to the client and starts it; setting the same client again does nothing
+    void setClient(GitHubClient* client);
+
+    PollScheduler* pollScheduler() const { return m_pollScheduler; }
+    NotificationDispatcher* dispatcher() const { return m_dispatcher; }
+
+    // Decides every notification once, starts triage for muted threads and returns the ones that belong in a list
+    QList<Notification> ingest(const QList<Notification>& notifications, bool append);
+    // Ids of the listed threads a "Mute" rule decided; their details are not worth fetching
+    const QSet<QString>& mutedThreads() const { return m_mutedThreads; }
+    // Pops up the new threads the rules let through, one by one or as a summary
+    void announce(const QList<Notification>& newItems);
+    // Drops a pending popup for a thread that was read in the meantime
+    void threadRead(const QString& id);
+
+    // Adds an "Open kgithub-notify" action to popups, for owners with a window to bring up
+    void setOfferOpenApp(bool offer) { m_offerOpenApp = offer; }
+
+   signals:
+    // The default or "Open kgithub-notify" action of a popup was used; `id` is empty for summaries
+    void popupActivated(const QString& id);
+
+   private slots:
+    void onSettingChanged(const QString& key);
+    void onScreenSaverActiveChanged(bool active);
+
+   private:
+    void setupPollPauses();
+    void sendPopup(const Notification& n);
+    void sendSummaryPopup(const QList<Notification>& notifications);
+
+    GitHubClient* m_client;
+    PollScheduler* m_pollScheduler;
+    NotificationDispatcher* m_dispatcher;
+    bool m_offerOpenApp;
+    QTimer* m_statsFlushTimer;  // Rule stats are written at most once per interval instead of after every poll
+
+    // Rule decisions made as notifications arrive, reused by announce() so each is evaluated once per poll
+    QHash<QString, RuleDecision> m_ingestDecisions;
+    // Thread id -> updated_at of muted threads already handled on the server; dropped again if the request fails
+    QHash<QString, QString> m_triagedThreads;
+    QSet<QString> m_mutedThreads;
+};
+
+#endif  // NOTIFICATIONENGINE_H
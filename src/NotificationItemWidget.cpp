@@ -6,24 +6,31 @@
 #include <QFont>
 #include <QIcon>
 #include <QLocale>
-#include <QPainter>
 #include <QPixmap>
 #include <QStyle>
+#include <QTimer>
 
-static QIcon getThemedIcon(const QStringList& names, QStyle* style, QStyle::StandardPixmap fallback) {
-    for (const QString& name : names) {
-        if (QIcon::hasThemeIcon(name)) {
-            return QIcon::fromTheme(name);
-        }
-    }
-    return style->standardIcon(fallback);
-}
+#include "IconCache.h"
+
+namespace {
+// Collapsed child rows are kept around briefly so quickly re-expanding a group is free
+const int kChildrenReleaseDelayMs = 30000;
+
+const QColor kUnreadColor(0, 122, 255);  // Blue
+}  // namespace
 
 NotificationItemWidget::NotificationItemWidget(const Notification& n, QWidget* parent)
-    : QWidget(parent), m_isLoading(false) {
+    : QWidget(parent),
+      childrenContainer(nullptr),
+      m_isLoading(false),
+      m_expanded(false),
+      m_hasAvatar(false),
+      m_children(n.groupedNotifications),
+      m_releaseTimer(nullptr) {
     QVBoxLayout* outerLayout = new QVBoxLayout(this);
     outerLayout->setContentsMargins(0, 0, 0, 0);
     outerLayout->setSpacing(0);
+    m_outerLayout = outerLayout;
 
     QWidget* topWidget = new QWidget(this);
     QHBoxLayout* mainLayout = new QHBoxLayout(topWidget);
@@ -35,25 +42,11 @@ NotificationItemWidget::NotificationItemWidget(const Notification& n, QWidget* p
     // Unread Indicator
     unreadIndicator = new QLabel(this);
     unreadIndicator->setFixedSize(10, 10);
-    QPixmap dot(10, 10);
-    dot.fill(Qt::transparent);
-    {
-        QPainter p(&dot);
-        p.setRenderHint(QPainter::Antialiasing);
-        p.setBrush(QColor(0, 122, 255));  // Blue
-        p.setPen(Qt::NoPen);
-        p.drawEllipse(0, 0, 10, 10);
-    }
-    unreadIndicator->setPixmap(dot);
     unreadIndicator->setVisible(n.unread);
     mainLayout->addWidget(unreadIndicator);
 
     avatarLabel = new QLabel(this);
     avatarLabel->setFixedSize(40, 40);
-    // Placeholder
-    QPixmap placeholder(40, 40);
-    placeholder.fill(Qt::lightGray);
-    avatarLabel->setPixmap(placeholder);
     mainLayout->addWidget(avatarLabel);
 
     QVBoxLayout* contentLayout = new QVBoxLayout();
@@ -131,7 +124,6 @@ NotificationItemWidget::NotificationItemWidget(const Notification& n, QWidget* p
 
     expandButton = new QToolButton(this);
     expandButton->setAutoRaise(true);
-    expandButton->setIcon(QIcon::fromTheme("go-down", style()->standardIcon(QStyle::SP_ArrowDown)));
     expandButton->setIconSize(QSize(24, 24));
     expandButton->setToolTip(tr("Expand Grouped Notifications"));
     expandButton->setVisible(!n.groupedNotifications.isEmpty());
@@ -139,9 +131,6 @@ NotificationItemWidget::NotificationItemWidget(const Notification& n, QWidget* p
 
     openButton = new QToolButton(this);
     openButton->setAutoRaise(true);
-    openButton->setIcon(getThemedIcon(
-        {QStringLiteral("internet-web-browser"), QStringLiteral("document-open-remote"), QStringLiteral("text-html")},
-        style(), QStyle::SP_DirOpenIcon));
     openButton->setIconSize(QSize(24, 24));
     openButton->setToolTip(tr("Open in Browser"));
     connect(openButton, &QToolButton::clicked, this, &NotificationItemWidget::openClicked);
@@ -149,9 +138,6 @@ NotificationItemWidget::NotificationItemWidget(const Notification& n, QWidget* p
 
     doneButton = new QToolButton(this);
     doneButton->setAutoRaise(true);
-    doneButton->setIcon(
-        getThemedIcon({QStringLiteral("task-complete"), QStringLiteral("object-select"), QStringLiteral("dialog-ok")},
-                      style(), QStyle::SP_DialogApplyButton));
     doneButton->setIconSize(QSize(24, 24));
     doneButton->setToolTip(tr("Mark as Done"));
     connect(doneButton, &QToolButton::clicked, this, &NotificationItemWidget::doneClicked);
@@ -160,103 +146,197 @@ NotificationItemWidget::NotificationItemWidget(const Notification& n, QWidget* p
     actionLayout->addStretch();
     mainLayout->addLayout(actionLayout);
 
+    // Child rows are only built the first time the group is expanded
+    connect(expandButton, &QToolButton::clicked, this, [this]() { setExpanded(!m_expanded); });
+
+    // Icons and pixmaps come from the shared cache and are re-fetched when the theme or palette changes
+    applyIcons();
+    connect(IconCache::instance(), &IconCache::invalidated, this, &NotificationItemWidget::applyIcons);
+
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Minimum);
+}
+
+void NotificationItemWidget::setExpanded(bool expanded) {
+    if (m_expanded == expanded) return;
+    m_expanded = expanded;
+
+    if (expanded) {
+        if (m_releaseTimer) m_releaseTimer->stop();
+        if (!childrenContainer) buildChildren();
+        childrenContainer->setVisible(true);
+    } else if (childrenContainer) {
+        childrenContainer->setVisible(false);
+        if (!m_releaseTimer) {
+            m_releaseTimer = new QTimer(this);
+            m_releaseTimer->setSingleShot(true);
+            m_releaseTimer->setInterval(kChildrenReleaseDelayMs);
+            connect(m_releaseTimer, &QTimer::timeout, this, &NotificationItemWidget::releaseChildren);
+        }
+        m_releaseTimer->start();
+    }
+
+    updateExpandIcon();
+    emit heightChanged();
+}
+
+void NotificationItemWidget::applyIcons() {
+    IconCache* cache = IconCache::instance();
+    const qreal dpr = devicePixelRatioF();
+
+    unreadIndicator->setPixmap(cache->dot(10, kUnreadColor, dpr));
+    if (!m_hasAvatar) {
+        avatarLabel->setPixmap(cache->placeholder(40, dpr));
+    }
+    updateExpandIcon();
+    openButton->setIcon(cache->themedIcon(
+        {QStringLiteral("internet-web-browser"), QStringLiteral("document-open-remote"), QStringLiteral("text-html")},
+        QStyle::SP_DirOpenIcon));
+    doneButton->setIcon(cache->themedIcon(
+        {QStringLiteral("task-complete"), QStringLiteral("object-select"), QStringLiteral("dialog-ok")},
+        QStyle::SP_DialogApplyButton));
+
+    // Child rows pick up the new icons when they are next built
+    if (childrenContainer && !m_expanded) {
+        releaseChildren();
+    } else if (childrenContainer) {
+        m_outerLayout->removeWidget(childrenContainer);
+        childrenContainer->deleteLater();
+        buildChildren();
+        childrenContainer->setVisible(true);
+    }
+}
+
+void NotificationItemWidget::updateExpandIcon() {
+    expandButton->setIcon(m_expanded ? IconCache::instance()->themedIcon({QStringLiteral("go-up")}, QStyle::SP_ArrowUp)
+                                     : IconCache::instance()->themedIcon({QStringLiteral("go-down")},
+                                                                         QStyle::SP_ArrowDown));
+}
+
+void NotificationItemWidget::buildChildren() {
     childrenContainer = new QWidget(this);
     QVBoxLayout* childrenLayout = new QVBoxLayout(childrenContainer);
     childrenLayout->setContentsMargins(40, 0, 5, 5);  // Indent children
     childrenLayout->setSpacing(2);
 
-    if (!n.groupedNotifications.isEmpty()) {
-        for (const auto& child : n.groupedNotifications) {
-            QString htmlUrl = GitHubClient::apiToHtmlUrl(child.url);
-            if (!child.htmlUrl.isEmpty()) {
-                htmlUrl = child.htmlUrl;
-            }
+    for (const auto& child : std::as_const(m_children)) {
+        QString htmlUrl = GitHubClient::apiToHtmlUrl(child.url);
+        if (!child.htmlUrl.isEmpty()) {
+            htmlUrl = child.htmlUrl;
+        }
 
-            QWidget* childWidget = new QWidget(this);
-            QHBoxLayout* childLayout = new QHBoxLayout(childWidget);
-            childLayout->setContentsMargins(0, 0, 0, 0);
-
-            QLabel* childUnread = new QLabel(this);
-            childUnread->setFixedSize(6, 6);
-            if (child.unread) {
-                QPixmap dot(6, 6);
-                dot.fill(Qt::transparent);
-                QPainter p(&dot);
-                p.setRenderHint(QPainter::Antialiasing);
-                p.setBrush(QColor(0, 122, 255));
-                p.setPen(Qt::NoPen);
-                p.drawEllipse(0, 0, 6, 6);
-                childUnread->setPixmap(dot);
-            } else {
-                childUnread->setVisible(false);
-            }
-            childLayout->addWidget(childUnread);
-
-            QLabel* childLabel = new QLabel(QString("↳ <a href=\"%1\"><b>%2</b>: %3</a>")
-                                                .arg(htmlUrl.toHtmlEscaped(), child.type, child.title.toHtmlEscaped()),
-                                            this);
-            childLabel->setTextFormat(Qt::RichText);
-            childLabel->setWordWrap(true);
-            childLabel->setOpenExternalLinks(false);
-            connect(childLabel, &QLabel::linkActivated, this,
-                    [this](const QString& link) { emit childOpenClicked(link); });
-            childLayout->addWidget(childLabel, 1);
-
-            QToolButton* copyBtn = new QToolButton(this);
-            copyBtn->setIcon(QIcon::fromTheme("edit-copy"));
-            copyBtn->setToolTip(tr("Copy Link"));
-            copyBtn->setIconSize(QSize(16, 16));
-            copyBtn->setAutoRaise(true);
-            connect(copyBtn, &QToolButton::clicked, this, [this, htmlUrl]() { emit childCopyClicked(htmlUrl); });
-            childLayout->addWidget(copyBtn);
-
-            QToolButton* readBtn = new QToolButton(this);
-            readBtn->setIcon(QIcon::fromTheme("mail-mark-read"));
-            readBtn->setToolTip(tr("Mark as Read"));
-            readBtn->setIconSize(QSize(16, 16));
-            readBtn->setAutoRaise(true);
-            readBtn->setVisible(child.unread);
-            connect(readBtn, &QToolButton::clicked, this, [this, child, childUnread, readBtn]() {
-                emit childMarkAsReadClicked(child.id);
-                childUnread->setVisible(false);
-                readBtn->setVisible(false);
-            });
-            childLayout->addWidget(readBtn);
-
-            QToolButton* doneBtn = new QToolButton(this);
-            doneBtn->setIcon(QIcon::fromTheme("task-complete"));
-            doneBtn->setToolTip(tr("Mark as Done"));
-            doneBtn->setIconSize(QSize(16, 16));
-            doneBtn->setAutoRaise(true);
-            connect(doneBtn, &QToolButton::clicked, this, [this, child, childWidget]() {
-                emit childMarkAsDoneClicked(child.id);
-                childWidget->setVisible(false);
-                emit heightChanged();
-            });
-            childLayout->addWidget(doneBtn);
-
-            childrenLayout->addWidget(childWidget);
+        QWidget* childWidget = new QWidget(childrenContainer);
+        QHBoxLayout* childLayout = new QHBoxLayout(childWidget);
+        childLayout->setContentsMargins(0, 0, 0, 0);
+
+        QLabel* childUnread = new QLabel(childWidget);
+        childUnread->setFixedSize(6, 6);
+        if (child.unread) {
+            childUnread->setPixmap(IconCache::instance()->dot(6, kUnreadColor, devicePixelRatioF()));
+        } else {
+            childUnread->setVisible(false);
         }
+        childLayout->addWidget(childUnread);
+
+        QLabel* childLabel = new QLabel(QString("↳ <a href=\"%1\"><b>%2</b>: %3</a>")
+                                            .arg(htmlUrl.toHtmlEscaped(), child.type, child.title.toHtmlEscaped()),
+                                        childWidget);
+        childLabel->setTextFormat(Qt::RichText);
+        childLabel->setWordWrap(true);
+        childLabel->setOpenExternalLinks(false);
+        connect(childLabel, &QLabel::linkActivated, this, [this](const QString& link) { emit childOpenClicked(link); });
+        childLayout->addWidget(childLabel, 1);
+
+        QToolButton* copyBtn = new QToolButton(childWidget);
+        copyBtn->setIcon(IconCache::instance()->themedIcon({QStringLiteral("edit-copy")}));
+        copyBtn->setToolTip(tr("Copy Link"));
+        copyBtn->setIconSize(QSize(16, 16));
+        copyBtn->setAutoRaise(true);
+        connect(copyBtn, &QToolButton::clicked, this, [this, htmlUrl]() { emit childCopyClicked(htmlUrl); });
+        childLayout->addWidget(copyBtn);
+
+        QString childId = child.id;
+        QToolButton* readBtn = new QToolButton(childWidget);
+        readBtn->setIcon(IconCache::instance()->themedIcon({QStringLiteral("mail-mark-read")}));
+        readBtn->setToolTip(tr("Mark as Read"));
+        readBtn->setIconSize(QSize(16, 16));
+        readBtn->setAutoRaise(true);
+        readBtn->setVisible(child.unread);
+        connect(readBtn, &QToolButton::clicked, this, [this, childId, childUnread, readBtn]() {
+            emit childMarkAsReadClicked(childId);
+            for (Notification& c : m_children) {
+                if (c.id == childId) c.unread = false;
+            }
+            childUnread->setVisible(false);
+            readBtn->setVisible(false);
+        });
+        childLayout->addWidget(readBtn);
+
+        QToolButton* doneBtn = new QToolButton(childWidget);
+        doneBtn->setIcon(IconCache::instance()->themedIcon({QStringLiteral("task-complete")}));
+        doneBtn->setToolTip(tr("Mark as Done"));
+        doneBtn->setIconSize(QSize(16, 16));
+        doneBtn->setAutoRaise(true);
+        connect(doneBtn, &QToolButton::clicked, this, [this, childId, childWidget]() {
+            emit childMarkAsDoneClicked(childId);
+            for (int i = 0; i < m_children.size(); ++i) {
+                if (m_children[i].id == childId) {
+                    m_children.removeAt(i);
+                    break;
+                }
+            }
+            childWidget->setVisible(false);
+            emit heightChanged();
+        });
+        childLayout->addWidget(doneBtn);
+
+        childrenLayout->addWidget(childWidget);
     }
 
     childrenContainer->setVisible(false);
-    outerLayout->addWidget(childrenContainer);
+    m_outerLayout->addWidget(childrenContainer);
+}
 
-    connect(expandButton, &QToolButton::clicked, this, [this]() {
-        bool isVisible = childrenContainer->isVisible();
-        childrenContainer->setVisible(!isVisible);
-        expandButton->setIcon(
-            QIcon::fromTheme(isVisible ? "go-down" : "go-up",
-                             style()->standardIcon(isVisible ? QStyle::SP_ArrowDown : QStyle::SP_ArrowUp)));
-        emit heightChanged();
-    });
+void NotificationItemWidget::releaseChildren() {
+    if (!childrenContainer || m_expanded) return;
 
-    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Minimum);
+    m_outerLayout->removeWidget(childrenContainer);
+    childrenContainer->deleteLater();
+    childrenContainer = nullptr;
+}
+
+void NotificationItemWidget::setChildren(const QList<Notification>& children) {
+    bool changed = children.size() != m_children.size();
+    for (int i = 0; !changed && i < children.size(); ++i) {
+        const Notification& a = children[i];
+        const Notification& b = m_children[i];
+        changed = a.id != b.id || a.unread != b.unread || a.title != b.title || a.htmlUrl != b.htmlUrl;
+    }
+    if (!changed) return;
+
+    m_children = children;
+    expandButton->setVisible(!m_children.isEmpty());
+
+    // Built rows are stale now; rebuild straight away only if they are on screen
+    if (childrenContainer) {
+        m_outerLayout->removeWidget(childrenContainer);
+        childrenContainer->deleteLater();
+        childrenContainer = nullptr;
+    }
+    if (m_expanded) {
+        if (m_children.isEmpty()) {
+            setExpanded(false);
+        } else {
+            buildChildren();
+            childrenContainer->setVisible(true);
+        }
+    }
+    emit heightChanged();
 }
 
 void NotificationItemWidget::setAuthor(const QString& name, const QPixmap& avatar) {
     authorLabel->setText("Author: " + name);
     if (!avatar.isNull()) {
+        m_hasAvatar = true;
         avatarLabel->setPixmap(avatar.scaled(40, 40, Qt::KeepAspectRatio, Qt::SmoothTransformation));
     }
 }
@@ -314,7 +394,9 @@ void NotificationItemWidget::updateNotification(const Notification& n) {
     // Update read status
     setRead(!n.unread);
 
-    // Note: Author and Avatar are updated separately via updateDetails/updateImage signals
+    setChildren(n.groupedNotifications);
+
+    // Note: Author and Avatar are updated separately via updateDetails and AvatarStore
     // Note: URL is often updated via details, but we can set the base one here
     QString htmlUrl = GitHubClient::apiToHtmlUrl(n.url);
     if (!n.htmlUrl.isEmpty()) {
@@ -4,6 +4,8 @@
 #include <QCheckBox>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QList>
+#include <QTimer>
 #include <QToolButton>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -19,7 +21,7 @@ class NotificationItemWidget : public QWidget {
     QToolButton* doneButton;
     QToolButton* openButton;
     QToolButton* expandButton;
-    QWidget* childrenContainer;
+    QWidget* childrenContainer;  // Built on first expand, released a while after collapsing
     QLabel* avatarLabel;
     QLabel* titleLabel;
     QLabel* repoLabel;
@@ -39,6 +41,8 @@ class NotificationItemWidget : public QWidget {
     void setLoading(bool loading);
     bool isLoading() const { return m_isLoading; }
     void updateNotification(const Notification& n);
+    void setExpanded(bool expanded);
+    bool isExpanded() const { return m_expanded; }
 
    signals:
     void doneClicked();
@@ -50,7 +54,18 @@ class NotificationItemWidget : public QWidget {
     void childMarkAsDoneClicked(const QString& id);
 
    private:
+    void buildChildren();
+    void releaseChildren();
+    void applyIcons();
+    void updateExpandIcon();
+    void setChildren(const QList<Notification>& children);
+
     bool m_isLoading;
+    bool m_expanded;
+    bool m_hasAvatar;
+    QList<Notification> m_children;
+    QVBoxLayout* m_outerLayout;
+    QTimer* m_releaseTimer;
 };
 
 #endif  // NOTIFICATIONITEMWIDGET_H
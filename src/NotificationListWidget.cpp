@@ -2,13 +2,16 @@
 
 #include <QApplication>
 #include <QClipboard>
+#include <QDebug>
 #include <QDesktopServices>
 #include <QDialog>
 #include <QDir>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QLabel>
 #include <QListWidgetItem>
+#include <QLocale>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QResizeEvent>
@@ -18,25 +21,80 @@
 #include <QTextEdit>
 #include <QTimer>
 #include <QVBoxLayout>
-#include <algorithm>
 
+#include "AppSettings.h"
+#include "AvatarStore.h"
 #include "GitHubClient.h"
+#include "KnownNotificationStore.h"
 #include "NotificationItemWidget.h"
 #include "NotificationRuleEngine.h"
+#include "NotificationStore.h"
+#include "NotificationViewPipeline.h"
 #include "NotificationWindow.h"
 #include "RulesDialog.h"
 #include "SettingsDialog.h"
+#include "UpdateCoalescer.h"
+
+namespace {
+// Author/avatar details rarely change, so a hydrated row is not refetched within this window
+const qint64 kDetailsTtlSecs = 6 * 60 * 60;
+// Failed detail requests are retried sooner than successful ones expire
+const qint64 kDetailsRetrySecs = 5 * 60;
+// In-flight requests for rows this far past the prefetch window are cancelled
+const int kHydrationKeepRows = 20;
+// Header rows of the grouped view carry their group key here instead of a notification id
+const int kGroupKeyRole = Qt::UserRole + 5;
+
+struct ViewRow {
+    const Notification* notification;
+    const NotificationGroup* group;
+};
+}  // namespace
 
 NotificationListWidget::NotificationListWidget(QWidget* parent)
     : QWidget(parent),
       loadMoreItem(nullptr),
       m_filterMode(0),
       m_sortMode(SortDefault),
+      m_groupMode(GroupNone),
       m_hasMore(false),
       m_pendingNewNotifications(0),
       m_countsDirty(false),
+      m_mergedUpdates(0),
+      m_modelChanged(false),
+      m_viewsReleased(false),
       m_client(nullptr) {
-    loadKnownNotifications();
+    m_knownStore = new KnownNotificationStore(
+        SettingsDialog::getNotifyOnce() ? KnownNotificationStore::defaultLogPath() : QString(), this);
+    m_knownStore->load(SettingsDialog::getKnownNotificationRetentionDays());
+    m_customSortKeys = SettingsDialog::getCustomSortKeys();
+    loadDetailsCache();
+
+    m_store = new NotificationStore(this);
+
+    m_viewPipeline = new NotificationViewPipeline(this);
+    connect(m_viewPipeline, &NotificationViewPipeline::viewReady, this, &NotificationListWidget::applyView);
+
+    m_hydrationTimer = new QTimer(this);
+    m_hydrationTimer->setSingleShot(true);
+    m_hydrationTimer->setInterval(50);
+    connect(m_hydrationTimer, &QTimer::timeout, this, &NotificationListWidget::hydrateVisibleRows);
+
+    m_detailsSaveTimer = new QTimer(this);
+    m_detailsSaveTimer->setSingleShot(true);
+    m_detailsSaveTimer->setInterval(5000);
+    connect(m_detailsSaveTimer, &QTimer::timeout, this, &NotificationListWidget::saveDetailsCache);
+    connect(AvatarStore::instance(), &AvatarStore::avatarReady, this, &NotificationListWidget::onAvatarReady);
+    connect(AvatarStore::instance(), &AvatarStore::avatarFailed, this,
+            [this](const QString& url) { m_avatarWaiters.remove(url); });
+
+    // Pages that arrive back to back during GetAll/Infinite loads are applied to the list in one pass
+    m_updateCoalescer = new UpdateCoalescer(16, this);
+    connect(m_updateCoalescer, &UpdateCoalescer::flush, this, &NotificationListWidget::onCoalescedUpdate);
+    // Group headers show per-group unread counts, so read/done changes made in place refresh them
+    connect(m_store, &NotificationStore::countsChanged, this, [this]() {
+        if (m_groupMode != GroupNone) m_updateCoalescer->schedule();
+    });
 
     QVBoxLayout* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
@@ -50,8 +108,19 @@ NotificationListWidget::NotificationListWidget(QWidget* parent)
 
     listWidget->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(listWidget, &QListWidget::customContextMenuRequested, this, &NotificationListWidget::onListContextMenu);
-    connect(listWidget->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() { handleLoadMoreStrategy(); });
+    connect(listWidget->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+        handleLoadMoreStrategy();
+        scheduleHydration();
+    });
+
+    m_staleBanner = new QLabel(this);
+    m_staleBanner->setWordWrap(true);
+    m_staleBanner->setContentsMargins(6, 4, 6, 4);
+    m_staleBanner->setBackgroundRole(QPalette::AlternateBase);
+    m_staleBanner->setAutoFillBackground(true);
+    m_staleBanner->setVisible(false);
 
+    layout->addWidget(m_staleBanner);
     layout->addWidget(listWidget);
 
     // Setup Context Menu
@@ -84,6 +153,7 @@ NotificationListWidget::NotificationListWidget(QWidget* parent)
 
         QString id = item->data(Qt::UserRole + 1).toString();
         emit markAsRead(id);
+        m_store->setUnread(id, false);
 
         if (widget) {
             widget->setRead(true);
@@ -150,23 +220,15 @@ NotificationListWidget::NotificationListWidget(QWidget* parent)
         QString currentId = item->data(Qt::UserRole + 1).toString();
         if (currentId.isEmpty()) return;
 
-        Notification n;
-        bool found = false;
-        for (const Notification& notif : m_allNotifications) {
-            if (notif.id == currentId) {
-                n = notif;
-                found = true;
-                break;
-            }
-        }
-        if (!found) return;
+        const Notification* n = m_store->find(currentId);
+        if (!n) return;
 
+        QString repository = n->repository;
         NotificationRule rule;
-        rule.repoFilter = n.repository;
+        rule.repoFilter = repository;
         rule.action = "Mute";
         NotificationRuleEngine::prependRule(rule);
-        QMessageBox::information(this, tr("Rule Added"),
-                                 tr("Muted notifications for repository:\n%1").arg(n.repository));
+        QMessageBox::information(this, tr("Rule Added"), tr("Muted notifications for repository:\n%1").arg(repository));
     });
 
     QAction* openRulesAction = new QAction(tr("Manage Notification Rules..."), this);
@@ -176,18 +238,11 @@ NotificationListWidget::NotificationListWidget(QWidget* parent)
         QString currentId = item->data(Qt::UserRole + 1).toString();
         if (currentId.isEmpty()) return;
 
-        Notification n;
-        bool found = false;
-        for (const Notification& notif : m_allNotifications) {
-            if (notif.id == currentId) {
-                n = notif;
-                found = true;
-                break;
-            }
-        }
-        if (!found) return;
+        const Notification* n = m_store->find(currentId);
+        if (!n) return;
 
-        RulesDialog dialog(this, n.repository, n.repository);
+        QString repository = n->repository;
+        RulesDialog dialog(this, repository, repository);
         dialog.exec();
     });
 
@@ -195,65 +250,195 @@ NotificationListWidget::NotificationListWidget(QWidget* parent)
     contextMenu->addAction(openRulesAction);
 }
 
+NotificationListWidget::~NotificationListWidget() {
+    if (m_detailsSaveTimer->isActive()) {
+        saveDetailsCache();
+    }
+}
+
 void NotificationListWidget::setNotifications(const QList<Notification>& notifications, bool append, bool hasMore) {
     if (!append) {
-        m_allNotifications = notifications;
+        m_store->setNotifications(notifications);
         m_pendingNewNotifications = 0;
         m_pendingNewlyAddedNotifications.clear();
+        setStaleSince(QDateTime());
     } else {
-        m_allNotifications.append(notifications);
+        m_store->appendNotifications(notifications);
     }
     m_hasMore = hasMore;
 
     for (const Notification& n : notifications) {
-        if (!knownNotificationIds.contains(n.id)) {
+        if (m_knownStore->insert(n.id)) {
             m_pendingNewNotifications++;
-            knownNotificationIds.insert(n.id);
             m_pendingNewlyAddedNotifications.append(n);
-            addKnownNotification(n.id);
         }
     }
 
     m_countsDirty = true;
+    m_modelChanged = true;
+    m_updateCoalescer->schedule();
+}
+
+void NotificationListWidget::restoreSnapshot(const QList<Notification>& notifications, const QDateTime& savedAt) {
+    m_store->setNotifications(notifications);
+    // Paging resumes once the server has confirmed the list
+    m_hasMore = false;
+    setStaleSince(savedAt.isValid() ? savedAt : QDateTime::currentDateTime());
+
+    m_countsDirty = true;
+    m_modelChanged = true;
+    m_updateCoalescer->schedule();
+}
+
+void NotificationListWidget::confirmSnapshot(bool hasMore) {
+    if (!isStale()) return;
+    setStaleSince(QDateTime());
+    if (m_hasMore != hasMore) {
+        m_hasMore = hasMore;
+        m_modelChanged = true;
+        m_updateCoalescer->schedule();
+    }
+}
+
+void NotificationListWidget::setStaleSince(const QDateTime& savedAt) {
+    bool wasStale = isStale();
+    m_staleSince = savedAt;
+    if (isStale()) {
+        m_staleBanner->setText(tr("Showing notifications saved %1; refreshing...")
+                                   .arg(QLocale::system().toString(savedAt, QLocale::ShortFormat)));
+    }
+    m_staleBanner->setVisible(isStale());
+    if (wasStale && !isStale()) scheduleHydration();
+}
+
+QStringList NotificationListWidget::avatarUrls() const {
+    QStringList urls;
+    for (const Notification& n : m_store->notifications()) {
+        auto it = detailsCache.constFind(n.id);
+        if (it != detailsCache.constEnd() && it->hasDetails && !it->avatarUrl.isEmpty()) {
+            urls.append(it->avatarUrl);
+        }
+    }
+    return urls;
+}
+
+void NotificationListWidget::releaseViews() {
+    if (m_viewsReleased) return;
+    m_viewsReleased = true;
+
+    // Taking the items down deletes their widgets, and with them every row's copy of the thread and its avatar
+    listWidget->clear();
+    loadMoreItem = nullptr;
+    m_avatarWaiters.clear();
+    for (const QString& id : std::as_const(m_hydrationInFlight)) {
+        emit cancelDetails(id);
+    }
+    m_hydrationInFlight.clear();
+}
+
+void NotificationListWidget::restoreViews() {
+    if (!m_viewsReleased) return;
+    m_viewsReleased = false;
+    m_updateCoalescer->schedule();
+}
 
-    // Emit progressively without triggering popups (newCount=0, empty list)
-    int totalUnread = 0;
-    for (const auto& n : m_allNotifications) {
-        if (n.unread) totalUnread++;
+void NotificationListWidget::dismissAll() {
+    if (!m_viewsReleased) {
+        selectAll();
+        dismissSelected();
+        return;
+    }
+
+    // There are no rows to select; dismiss the threads straight from the store
+    const QList<Notification> notifications = m_store->notifications();
+    for (const Notification& n : notifications) {
+        emit markAsDone(n.id);
+        m_store->removeNotification(n.id);
     }
-    emit countsChanged(m_allNotifications.count(), totalUnread, 0, QList<Notification>());
+    m_countsDirty = true;
+    m_updateCoalescer->schedule();
+}
 
+void NotificationListWidget::onCoalescedUpdate(int mergedCount) {
+    if (m_viewsReleased) {
+        // No view to build, but new notifications still have to be counted and announced
+        m_modelChanged = false;
+        handleLoadMoreStrategy();
+        return;
+    }
+    m_mergedUpdates = mergedCount;
     updateList();
 }
 
 void NotificationListWidget::resizeEvent(QResizeEvent* event) {
     QWidget::resizeEvent(event);
     handleLoadMoreStrategy();
+    scheduleHydration();
 }
 
 void NotificationListWidget::setFilterMode(int mode) {
     if (m_filterMode == mode) return;
     m_filterMode = mode;
-    updateList();
+    m_updateCoalescer->schedule();
 }
 
 void NotificationListWidget::setSortMode(int mode) {
     SortMode newMode = static_cast<SortMode>(mode);
     if (m_sortMode == newMode) return;
     m_sortMode = newMode;
-    updateList();
+    m_sortKeys = sortCriteriaFor(m_sortMode);
+    m_updateCoalescer->schedule();
+}
+
+void NotificationListWidget::setCustomSortKeys(const QString& spec) {
+    m_customSortKeys = spec;
+    if (m_sortMode != SortCustom) return;
+    m_sortKeys = sortCriteriaFor(m_sortMode);
+    m_updateCoalescer->schedule();
+}
+
+QList<NotificationSorter::SortKey> NotificationListWidget::sortCriteriaFor(SortMode mode) const {
+    // Text sorts fall back to newest first, matching the old single-key comparators
+    switch (mode) {
+        case SortUpdatedDesc:
+            return NotificationSorter::parseCriteria("-updated");
+        case SortUpdatedAsc:
+            return NotificationSorter::parseCriteria("updated");
+        case SortRepoAsc:
+            return NotificationSorter::parseCriteria("repository,-updated");
+        case SortRepoDesc:
+            return NotificationSorter::parseCriteria("-repository,-updated");
+        case SortTitleAsc:
+            return NotificationSorter::parseCriteria("title,-updated");
+        case SortTitleDesc:
+            return NotificationSorter::parseCriteria("-title,-updated");
+        case SortTypeAsc:
+            return NotificationSorter::parseCriteria("type,-updated");
+        case SortTypeDesc:
+            return NotificationSorter::parseCriteria("-type,-updated");
+        case SortLastReadDesc:
+            return NotificationSorter::parseCriteria("-lastread,-updated");
+        case SortLastReadAsc:
+            return NotificationSorter::parseCriteria("lastread,-updated");
+        case SortRepoReasonUpdated:
+            return NotificationSorter::parseCriteria("repository,reason,-updated");
+        case SortCustom:
+            return NotificationSorter::parseCriteria(m_customSortKeys);
+        default:
+            return QList<NotificationSorter::SortKey>();
+    }
 }
 
 void NotificationListWidget::setRepoFilter(const QString& repo) {
     if (m_repoFilter == repo) return;
     m_repoFilter = repo;
-    applyClientFilters();
+    m_updateCoalescer->schedule();
 }
 
 void NotificationListWidget::setSearchFilter(const QString& text) {
     if (m_searchFilter == text) return;
     m_searchFilter = text;
-    applyClientFilters();
+    m_updateCoalescer->schedule();
 }
 
 void NotificationListWidget::selectAll() { listWidget->selectAll(); }
@@ -265,9 +450,11 @@ void NotificationListWidget::selectTop(int n) {
     int count = listWidget->count();
     int limit = qMin(n, count);
 
-    for (int i = 0; i < limit; ++i) {
+    for (int i = 0; i < count && limit > 0; ++i) {
         QListWidgetItem* item = listWidget->item(i);
-        if (item) item->setSelected(true);
+        if (!item || item == loadMoreItem || isGroupHeader(item)) continue;
+        item->setSelected(true);
+        limit--;
     }
 }
 
@@ -290,6 +477,7 @@ void NotificationListWidget::dismissSelected() {
             item->setFont(font);
 
             emit markAsDone(id);  // Effectively mark as read and done
+            m_store->removeNotification(id);
 
             // Remove item from list
             delete listWidget->takeItem(listWidget->row(item));
@@ -310,24 +498,24 @@ bool NotificationListWidget::willLoadMore() const {
     QPushButton* btn = qobject_cast<QPushButton*>(listWidget->itemWidget(loadMoreItem));
     if (!btn || !btn->isEnabled()) return false;
 
-    SettingsDialog::GetDataOption option = SettingsDialog::getGetDataOption();
+    AppSettings::GetDataOption option = SettingsDialog::getGetDataOption();
 
-    if (option == SettingsDialog::Manual) {
+    if (option == AppSettings::Manual) {
         return false;
     }
 
-    if (option == SettingsDialog::FillScreen) {
+    if (option == AppSettings::FillScreen) {
         if (listWidget->verticalScrollBar()->maximum() <= 0) {
             return true;
         }
         return false;
     }
 
-    if (option == SettingsDialog::GetAll) {
+    if (option == AppSettings::GetAll) {
         return true;
     }
 
-    if (option == SettingsDialog::Infinite) {
+    if (option == AppSettings::Infinite) {
         QRect itemRect = listWidget->visualItemRect(loadMoreItem);
         QRect viewportRect = listWidget->viewport()->rect();
         if (viewportRect.intersects(itemRect)) {
@@ -339,6 +527,9 @@ bool NotificationListWidget::willLoadMore() const {
 }
 
 void NotificationListWidget::handleLoadMoreStrategy() {
+    // The list does not reflect the model yet; the pending view re-runs this once it has been applied
+    if (m_updateCoalescer->isPending() || m_viewPipeline->isPending()) return;
+
     bool currentlyLoading = false;
     if (loadMoreItem) {
         QPushButton* btn = qobject_cast<QPushButton*>(listWidget->itemWidget(loadMoreItem));
@@ -350,11 +541,7 @@ void NotificationListWidget::handleLoadMoreStrategy() {
     if (willLoadMore()) {
         triggerLoadMore();
     } else if (!currentlyLoading && m_countsDirty) {
-        int totalUnread = 0;
-        for (const auto& n : m_allNotifications) {
-            if (n.unread) totalUnread++;
-        }
-        emit countsChanged(m_allNotifications.count(), totalUnread, m_pendingNewNotifications,
+        emit countsChanged(m_store->totalCount(), m_store->unreadCount(), m_pendingNewNotifications,
                            m_pendingNewlyAddedNotifications);
         m_pendingNewNotifications = 0;
         m_pendingNewlyAddedNotifications.clear();
@@ -363,67 +550,89 @@ void NotificationListWidget::handleLoadMoreStrategy() {
 }
 
 void NotificationListWidget::focusNotification(const QString& id) {
+    if (m_viewsReleased) {
+        // Focused once the rows are back
+        m_pendingFocusId = id;
+        return;
+    }
+
     for (int i = 0; i < listWidget->count(); ++i) {
         QListWidgetItem* item = listWidget->item(i);
         if (item->data(Qt::UserRole + 1).toString() == id) {
             listWidget->scrollToItem(item);
             listWidget->setCurrentItem(item);
             emit notificationActivated(id);
-            break;
+            return;
         }
     }
-}
 
-QStringList NotificationListWidget::getAvailableRepos() const {
-    QSet<QString> repos;
-    // Iterate over visible items or all items?
-    // Usually repo filter is based on currently loaded items
-    for (int i = 0; i < listWidget->count(); ++i) {
-        QListWidgetItem* item = listWidget->item(i);
-        if (item == loadMoreItem) continue;
-        QString repo = item->data(Qt::UserRole + 3).toString();
-        if (!repo.isEmpty()) {
-            repos.insert(repo);
+    // The row may sit in a collapsed group; expand it and focus once the view has been rebuilt
+    const Notification* n = m_store->find(id);
+    if (m_groupMode != GroupNone && n) {
+        QString key = NotificationViewPipeline::groupKey(*n, m_groupMode);
+        if (!m_expandedGroups.contains(key)) {
+            m_pendingFocusId = id;
+            setGroupExpanded(key, true);
         }
     }
-    QStringList repoList = repos.values();
-    repoList.sort();
-    return repoList;
 }
 
-int NotificationListWidget::count() const { return listWidget->count(); }
+QStringList NotificationListWidget::getAvailableRepos() const { return m_store->repositories(); }
+
+int NotificationListWidget::count() const {
+    // Released rows are still there as far as callers are concerned
+    return m_viewsReleased ? m_store->totalCount() : listWidget->count();
+}
+
+const QList<Notification>& NotificationListWidget::allNotifications() const { return m_store->notifications(); }
 
 void NotificationListWidget::updateDetails(const QString& id, const QString& author, const QString& avatarUrl,
                                            const QString& htmlUrl) {
+    m_hydrationInFlight.remove(id);
+
     NotificationDetails& details = detailsCache[id];
     details.author = author;
     details.avatarUrl = avatarUrl;
     details.htmlUrl = htmlUrl;
+    details.fetchedAt = QDateTime::currentDateTimeUtc();
     details.hasDetails = true;
+    scheduleDetailsCacheSave();
 
     NotificationItemWidget* widget = findNotificationWidget(id);
     if (widget) {
-        widget->setAuthor(author, details.avatar);
+        widget->setAuthor(author, avatarFor(id, avatarUrl));
         widget->setHtmlUrl(htmlUrl);
     }
+}
+
+QPixmap NotificationListWidget::avatarFor(const QString& id, const QString& avatarUrl) {
+    if (avatarUrl.isEmpty()) return QPixmap();
 
-    if (!details.hasImage && !avatarUrl.isEmpty()) {
-        emit requestImage(avatarUrl, id);
+    QPixmap pixmap = AvatarStore::instance()->avatar(avatarUrl);
+    if (pixmap.isNull()) {
+        // Not cached yet or evicted under the memory budget; the row is filled in once it arrives
+        if (!m_avatarWaiters.contains(avatarUrl, id)) m_avatarWaiters.insert(avatarUrl, id);
+        AvatarStore::instance()->request(avatarUrl);
     }
+    return pixmap;
 }
 
-void NotificationListWidget::updateImage(const QString& id, const QPixmap& pixmap) {
-    NotificationDetails& details = detailsCache[id];
-    details.avatar = pixmap;
-    details.hasImage = true;
+void NotificationListWidget::onAvatarReady(const QString& url, const QPixmap& pixmap) {
+    const QList<QString> ids = m_avatarWaiters.values(url);
+    m_avatarWaiters.remove(url);
 
-    NotificationItemWidget* widget = findNotificationWidget(id);
-    if (widget) {
-        widget->setAuthor(details.author, pixmap);
+    for (const QString& id : ids) {
+        NotificationItemWidget* widget = findNotificationWidget(id);
+        if (widget) {
+            widget->setAuthor(detailsCache.value(id).author, pixmap);
+        }
     }
 }
 
 void NotificationListWidget::updateError(const QString& id, const QString& error) {
+    m_hydrationInFlight.remove(id);
+    detailsCache[id].fetchedAt = QDateTime::currentDateTimeUtc();
+
     NotificationItemWidget* widget = findNotificationWidget(id);
     if (widget) {
         widget->setError(error);
@@ -432,6 +641,10 @@ void NotificationListWidget::updateError(const QString& id, const QString& error
 
 void NotificationListWidget::onListContextMenu(const QPoint& pos) {
     QListWidgetItem* item = listWidget->itemAt(pos);
+    if (isGroupHeader(item)) {
+        onGroupContextMenu(item, listWidget->mapToGlobal(pos));
+        return;
+    }
     if (item) {
         NotificationItemWidget* widget = qobject_cast<NotificationItemWidget*>(listWidget->itemWidget(item));
         if (widget && widget->isLoading()) return;
@@ -447,7 +660,14 @@ void NotificationListWidget::onListContextMenu(const QPoint& pos) {
     }
 }
 
-void NotificationListWidget::onItemActivated(QListWidgetItem* item) { openWindowForItem(item); }
+void NotificationListWidget::onItemActivated(QListWidgetItem* item) {
+    if (isGroupHeader(item)) {
+        QString key = item->data(kGroupKeyRole).toString();
+        setGroupExpanded(key, !m_expandedGroups.contains(key));
+        return;
+    }
+    openWindowForItem(item);
+}
 
 void NotificationListWidget::triggerLoadMore() {
     if (!loadMoreItem) return;
@@ -466,14 +686,11 @@ void NotificationListWidget::insertNotificationItem(int row, const Notification&
     QListWidgetItem* item = new QListWidgetItem();
     NotificationItemWidget* widget = new NotificationItemWidget(n);
 
-    if (detailsCache.contains(n.id)) {
-        const NotificationDetails& details = detailsCache[n.id];
-        if (details.hasDetails) {
-            widget->setAuthor(details.author, details.avatar);
-            widget->setHtmlUrl(details.htmlUrl);
-        }
-    } else {
-        emit requestDetails(n.url, n.id);
+    // Details for rows without a cache entry are fetched by hydrateVisibleRows() once the row is near the viewport
+    auto detailsIt = detailsCache.constFind(n.id);
+    if (detailsIt != detailsCache.constEnd() && detailsIt->hasDetails) {
+        widget->setAuthor(detailsIt->author, avatarFor(n.id, detailsIt->avatarUrl));
+        widget->setHtmlUrl(detailsIt->htmlUrl);
     }
 
     item->setData(Qt::UserRole, n.url);
@@ -518,13 +735,7 @@ void NotificationListWidget::insertNotificationItem(int row, const Notification&
             }
         }
         item->setData(Qt::UserRole + 4, n.toJson());
-
-        for (int i = 0; i < m_allNotifications.size(); ++i) {
-            if (m_allNotifications[i].id == n.id) {
-                m_allNotifications[i] = n;
-                break;
-            }
-        }
+        m_store->updateNotification(n);
     });
 
     connect(widget, &NotificationItemWidget::childMarkAsDoneClicked, this, [this, item](const QString& id) {
@@ -539,13 +750,7 @@ void NotificationListWidget::insertNotificationItem(int row, const Notification&
             }
         }
         item->setData(Qt::UserRole + 4, n.toJson());
-
-        for (int i = 0; i < m_allNotifications.size(); ++i) {
-            if (m_allNotifications[i].id == n.id) {
-                m_allNotifications[i] = n;
-                break;
-            }
-        }
+        m_store->updateNotification(n);
     });
 
     connect(
@@ -562,162 +767,95 @@ void NotificationListWidget::insertNotificationItem(int row, const Notification&
 }
 
 void NotificationListWidget::updateList() {
+    NotificationViewParams params;
+    params.filterMode = m_filterMode;
+    params.groupMode = m_groupMode;
+    params.expandedGroups = m_expandedGroups;
+    params.sortKeys = m_sortKeys;
+    if (m_repoFilter != tr("All Repositories")) {
+        params.repoFilter = m_repoFilter;
+    }
+    params.searchFilter = m_searchFilter;
+
+    // The store's list is implicitly shared, so handing it to the worker is a reference count bump
+    m_viewPipeline->request(m_store->notifications(), params);
+}
+
+void NotificationListWidget::applyView(const NotificationView& view) {
+    // Requested before the rows were released; restoreViews() asks for a fresh one. Counts held back while it
+    // was on its way are reported now.
+    if (m_viewsReleased) {
+        QTimer::singleShot(0, this, &NotificationListWidget::handleLoadMoreStrategy);
+        return;
+    }
+
     listWidget->setUpdatesEnabled(false);
     emit statusMessage(tr("Updating list..."));
 
-    // Prepare Target List
-    QList<Notification> targetNotifications;
-    for (const Notification& n : m_allNotifications) {
-        bool show = false;
-
-        QDateTime updated = QDateTime::fromString(n.updatedAt, Qt::ISODate);
-        QDateTime lastRead = QDateTime::fromString(n.lastReadAt, Qt::ISODate);
-        bool hasBeenRead = !n.lastReadAt.isEmpty();
-        bool updatedRecently = hasBeenRead && updated > lastRead;
-
-        if (m_filterMode == 0) {  // All Unread
-            if (n.unread) show = true;
-        } else if (m_filterMode == 1) {  // All Read before Updated
-            if (hasBeenRead && !updatedRecently) show = true;
-        } else if (m_filterMode == 2) {  // Updated recently
-            if (updatedRecently) show = true;
-        } else if (m_filterMode == 3) {  // All read
-            if (!n.unread) show = true;
-        } else if (m_filterMode == 4) {  // All
-            show = true;
-        } else if (m_filterMode == 5) {  // Mentions (Unread)
-            if (n.unread && n.reason == "mention") show = true;
-        } else if (m_filterMode == 6) {  // Mentions (All)
-            if (n.reason == "mention") show = true;
-        } else if (m_filterMode == 7) {  // CI Activity (Unread)
-            if (n.unread && n.reason == "ci_activity") show = true;
-        } else if (m_filterMode == 8) {  // CI Activity (All)
-            if (n.reason == "ci_activity") show = true;
-        } else if (m_filterMode == 9) {  // Review Requested (Unread)
-            if (n.unread && n.reason == "review_requested") show = true;
-        } else if (m_filterMode == 10) {  // Review Requested (All)
-            if (n.reason == "review_requested") show = true;
-        } else if (m_filterMode == 11) {  // Subscribed (Unread)
-            if (n.unread && n.reason == "subscribed") show = true;
-        } else if (m_filterMode == 12) {  // Subscribed (All)
-            if (n.reason == "subscribed") show = true;
+    // Items removed from the store after the snapshot was taken are dropped here. In a grouped view each
+    // group gets a header row and only expanded groups contribute member rows.
+    QList<ViewRow> rows;
+    rows.reserve(view.ids.size() + view.groups.size());
+    auto appendMembers = [this, &rows](const QStringList& ids) {
+        for (const QString& id : ids) {
+            const Notification* n = m_store->find(id);
+            if (n) rows.append(ViewRow{n, nullptr});
         }
-        if (show) {
-            targetNotifications.append(n);
+    };
+    if (view.groups.isEmpty()) {
+        appendMembers(view.ids);
+    } else {
+        for (const NotificationGroup& group : view.groups) {
+            rows.append(ViewRow{nullptr, &group});
+            appendMembers(group.ids);
         }
     }
 
-    // Sort the list
-    if (m_sortMode != SortDefault) {
-        std::sort(targetNotifications.begin(), targetNotifications.end(),
-                  [this](const Notification& a, const Notification& b) {
-                      switch (m_sortMode) {
-                          case SortUpdatedDesc:
-                              return a.updatedAt > b.updatedAt;
-                          case SortUpdatedAsc:
-                              return a.updatedAt < b.updatedAt;
-                          case SortRepoAsc: {
-                              int cmp = a.repository.compare(b.repository, Qt::CaseInsensitive);
-                              if (cmp != 0) return cmp < 0;
-                              return a.updatedAt > b.updatedAt;
-                          }
-                          case SortRepoDesc: {
-                              int cmp = a.repository.compare(b.repository, Qt::CaseInsensitive);
-                              if (cmp != 0) return cmp > 0;
-                              return a.updatedAt > b.updatedAt;
-                          }
-                          case SortTitleAsc: {
-                              int cmp = a.title.compare(b.title, Qt::CaseInsensitive);
-                              if (cmp != 0) return cmp < 0;
-                              return a.updatedAt > b.updatedAt;
-                          }
-                          case SortTitleDesc: {
-                              int cmp = a.title.compare(b.title, Qt::CaseInsensitive);
-                              if (cmp != 0) return cmp > 0;
-                              return a.updatedAt > b.updatedAt;
-                          }
-                          case SortTypeAsc: {
-                              int cmp = a.type.compare(b.type, Qt::CaseInsensitive);
-                              if (cmp != 0) return cmp < 0;
-                              return a.updatedAt > b.updatedAt;
-                          }
-                          case SortTypeDesc: {
-                              int cmp = a.type.compare(b.type, Qt::CaseInsensitive);
-                              if (cmp != 0) return cmp > 0;
-                              return a.updatedAt > b.updatedAt;
-                          }
-                          case SortLastReadDesc:
-                              if (a.lastReadAt.isEmpty() && b.lastReadAt.isEmpty()) return a.updatedAt > b.updatedAt;
-                              if (a.lastReadAt.isEmpty()) return false;  // Nulls at end
-                              if (b.lastReadAt.isEmpty()) return true;
-                              return a.lastReadAt > b.lastReadAt;
-                          case SortLastReadAsc:
-                              if (a.lastReadAt.isEmpty() && b.lastReadAt.isEmpty()) return a.updatedAt > b.updatedAt;
-                              if (a.lastReadAt.isEmpty()) return true;  // Nulls at beginning
-                              if (b.lastReadAt.isEmpty()) return false;
-                              return a.lastReadAt < b.lastReadAt;
-                          default:
-                              return a.updatedAt > b.updatedAt;
-                      }
-                  });
-    }
-
     // Sync Loop
     int i = 0;
-    while (i < targetNotifications.size()) {
-        const Notification& n = targetNotifications[i];
+    while (i < rows.size()) {
+        const ViewRow& row = rows[i];
+        QString key = row.notification ? row.notification->id : groupRowKey(row.group->key);
         QListWidgetItem* currentItem = listWidget->item(i);
 
-        // Check if current item matches target
-        QString currentId = currentItem ? currentItem->data(Qt::UserRole + 1).toString() : QString();
+        // Skip "Load More" item if encountered during sync (should be at end); insert before it instead
+        QString currentKey = (currentItem && currentItem != loadMoreItem) ? rowKey(currentItem) : QString();
 
-        // Skip "Load More" item if encountered during sync (should be at end)
-        if (currentItem == loadMoreItem && loadMoreItem != nullptr) {
-            // If we hit load more item but still have notifications to place,
-            // we need to insert before it.
-            currentId = "";  // Treat as mismatch
-        }
-
-        if (currentItem && currentId == n.id) {
+        if (currentItem && currentKey == key) {
             // Match: Update existing
-            NotificationItemWidget* widget = qobject_cast<NotificationItemWidget*>(listWidget->itemWidget(currentItem));
-            if (widget) {
-                widget->updateNotification(n);
+            if (row.group) {
+                updateGroupHeader(currentItem, *row.group);
+            } else {
+                NotificationItemWidget* widget =
+                    qobject_cast<NotificationItemWidget*>(listWidget->itemWidget(currentItem));
+                if (widget) {
+                    widget->updateNotification(*row.notification);
+                }
+                // Font update is handled in updateNotification -> setRead
+                currentItem->setData(Qt::UserRole + 4, row.notification->toJson());
             }
-            // Update Item Data
-            currentItem->setData(Qt::UserRole + 4, n.toJson());
-            // Font update is handled in updateNotification -> setRead
-            i++;
         } else {
-            // Mismatch
-            // Check if n.id exists later in the list
-            int foundIndex = -1;
+            // Mismatch: drop the row if it exists further down, then insert it here
             for (int k = i + 1; k < listWidget->count(); ++k) {
                 QListWidgetItem* searchItem = listWidget->item(k);
                 if (searchItem == loadMoreItem) continue;
-                if (searchItem->data(Qt::UserRole + 1).toString() == n.id) {
-                    foundIndex = k;
+                if (rowKey(searchItem) == key) {
+                    QWidget* widget = listWidget->itemWidget(searchItem);
+                    if (widget) {
+                        widget->deleteLater();
+                    }
+                    delete listWidget->takeItem(k);
                     break;
                 }
             }
 
-            if (foundIndex != -1) {
-                // Found later: Move it to current position 'i'
-                // Safely remove old item and widget
-                QWidget* widget = listWidget->itemWidget(listWidget->item(foundIndex));
-                if (widget) {
-                    widget->deleteLater();
-                }
-                QListWidgetItem* movedItem = listWidget->takeItem(foundIndex);
-                delete movedItem;
-
-                insertNotificationItem(i, n);
+            if (row.group) {
+                insertGroupHeader(i, *row.group);
             } else {
-                // Not found: Insert new
-                insertNotificationItem(i, n);
+                insertNotificationItem(i, *row.notification);
             }
-            i++;
         }
+        i++;
     }
 
     // Cleanup: Remove remaining items starting from i (excluding loadMoreItem if we want to keep it logic clean)
@@ -784,46 +922,255 @@ void NotificationListWidget::updateList() {
         }
     }
 
-    applyClientFilters();
+    // Group headers already took their visibility from the group's filtered member count
+    int visibleCount = 0;
+    for (int k = 0; k < listWidget->count(); ++k) {
+        QListWidgetItem* item = listWidget->item(k);
+        if (item == loadMoreItem || isGroupHeader(item)) continue;
+        bool visible = !view.hidden.contains(item->data(Qt::UserRole + 1).toString());
+        item->setHidden(!visible);
+        if (visible) visibleCount++;
+    }
+
+    m_groupKeys.clear();
+    for (const NotificationGroup& group : view.groups) {
+        m_groupKeys.append(group.key);
+        if (!group.expanded) visibleCount += group.visible;
+    }
 
     listWidget->setUpdatesEnabled(true);
-    emit statusMessage(tr("Items: %1").arg(listWidget->count() - (loadMoreItem ? 1 : 0)));
+    if (m_mergedUpdates > 1) {
+        emit statusMessage(tr("Items: %1 (%2 changes in one update)").arg(visibleCount).arg(m_mergedUpdates));
+    } else {
+        emit statusMessage(tr("Items: %1").arg(visibleCount));
+    }
+    m_mergedUpdates = 0;
 
     QTimer::singleShot(0, this, &NotificationListWidget::handleLoadMoreStrategy);
+    scheduleHydration();
+
+    if (!m_pendingFocusId.isEmpty()) {
+        QString id = m_pendingFocusId;
+        m_pendingFocusId.clear();
+        focusNotification(id);
+    }
+
+    if (m_modelChanged) {
+        m_modelChanged = false;
+
+        // Emit progressively without triggering popups (newCount=0, empty list)
+        emit countsChanged(m_store->totalCount(), m_store->unreadCount(), 0, QList<Notification>());
+    }
 }
 
-void NotificationListWidget::applyClientFilters() {
-    bool filterRepo = (m_repoFilter != tr("All Repositories") && !m_repoFilter.isEmpty());
-    bool filterText = !m_searchFilter.isEmpty();
+QString NotificationListWidget::groupRowKey(const QString& groupKey) {
+    // Thread ids never contain control characters, so header keys cannot collide with them
+    return QChar(0x1F) + groupKey;
+}
 
-    int visibleCount = 0;
+QString NotificationListWidget::rowKey(QListWidgetItem* item) {
+    QVariant groupKey = item->data(kGroupKeyRole);
+    if (groupKey.isValid()) return groupRowKey(groupKey.toString());
+    return item->data(Qt::UserRole + 1).toString();
+}
 
-    for (int i = 0; i < listWidget->count(); ++i) {
-        QListWidgetItem* item = listWidget->item(i);
-        if (item == loadMoreItem) continue;
+bool NotificationListWidget::isGroupHeader(QListWidgetItem* item) {
+    return item && item->data(kGroupKeyRole).isValid();
+}
 
-        bool matchRepo = true;
-        if (filterRepo) {
-            QString repo = item->data(Qt::UserRole + 3).toString();
-            if (repo != m_repoFilter) matchRepo = false;
+void NotificationListWidget::insertGroupHeader(int row, const NotificationGroup& group) {
+    QListWidgetItem* item = new QListWidgetItem();
+    item->setData(kGroupKeyRole, group.key);
+    item->setFlags(Qt::ItemIsEnabled);
+    QFont font = item->font();
+    font.setBold(true);
+    item->setFont(font);
+    updateGroupHeader(item, group);
+
+    listWidget->insertItem(row, item);
+}
+
+void NotificationListWidget::updateGroupHeader(QListWidgetItem* item, const NotificationGroup& group) {
+    QString name = group.key.isEmpty() ? tr("(None)") : group.key;
+    QChar arrow = group.expanded ? QChar(0x25BE) : QChar(0x25B8);
+    item->setText(tr("%1 %2 (%3 unread, %4 total)").arg(arrow).arg(name).arg(group.unread).arg(group.total));
+    item->setHidden(group.visible == 0);
+}
+
+void NotificationListWidget::setGroupMode(int mode) {
+    if (m_groupMode == mode) return;
+    m_groupMode = mode;
+    m_expandedGroups.clear();
+    m_updateCoalescer->schedule();
+}
+
+void NotificationListWidget::setGroupExpanded(const QString& key, bool expanded) {
+    if (m_expandedGroups.contains(key) == expanded) return;
+    if (expanded) {
+        m_expandedGroups.insert(key);
+    } else {
+        m_expandedGroups.remove(key);
+    }
+    m_updateCoalescer->schedule();
+}
+
+void NotificationListWidget::setAllGroupsExpanded(bool expanded) {
+    if (expanded) {
+        for (const QString& key : std::as_const(m_groupKeys)) {
+            m_expandedGroups.insert(key);
         }
+    } else {
+        m_expandedGroups.clear();
+    }
+    m_updateCoalescer->schedule();
+}
 
-        bool matchText = true;
-        if (filterText) {
-            QString title = item->data(Qt::UserRole + 2).toString();
-            QString repo = item->data(Qt::UserRole + 3).toString();
-            if (!title.contains(m_searchFilter, Qt::CaseInsensitive) &&
-                !repo.contains(m_searchFilter, Qt::CaseInsensitive)) {
-                matchText = false;
-            }
+void NotificationListWidget::onGroupContextMenu(QListWidgetItem* item, const QPoint& globalPos) {
+    QString key = item->data(kGroupKeyRole).toString();
+    bool expanded = m_expandedGroups.contains(key);
+
+    QMenu menu(this);
+    QAction* toggleAction = menu.addAction(expanded ? tr("Collapse") : tr("Expand"));
+    connect(toggleAction, &QAction::triggered, this, [this, key, expanded]() { setGroupExpanded(key, !expanded); });
+    QAction* expandAllAction = menu.addAction(tr("Expand All Groups"));
+    connect(expandAllAction, &QAction::triggered, this, [this]() { setAllGroupsExpanded(true); });
+    QAction* collapseAllAction = menu.addAction(tr("Collapse All Groups"));
+    connect(collapseAllAction, &QAction::triggered, this, [this]() { setAllGroupsExpanded(false); });
+    if (m_groupMode == GroupByRepository && !key.isEmpty()) {
+        menu.addSeparator();
+        QAction* filterAction = menu.addAction(tr("Show Only This Repository"));
+        connect(filterAction, &QAction::triggered, this, [this, key]() { emit repoFilterRequested(key); });
+    }
+    menu.exec(globalPos);
+}
+
+void NotificationListWidget::scheduleHydration() {
+    // Throttle rather than debounce so rows keep filling in during a long scroll
+    if (!m_hydrationTimer->isActive()) {
+        m_hydrationTimer->start();
+    }
+}
+
+void NotificationListWidget::hydrateVisibleRows() {
+    // A restored snapshot may predate the token; cached details are shown and the rest waits for fresh data
+    if (isStale()) return;
+
+    const int rowCount = listWidget->count();
+
+    int firstVisible = 0;
+    int lastVisible = rowCount - 1;
+    QRect viewportRect = listWidget->viewport()->rect();
+    QModelIndex firstIndex = listWidget->indexAt(viewportRect.topLeft());
+    QModelIndex lastIndex = listWidget->indexAt(viewportRect.bottomLeft());
+    if (firstIndex.isValid()) firstVisible = firstIndex.row();
+    if (lastIndex.isValid()) lastVisible = lastIndex.row();
+
+    // Walk outwards from a row until the given number of non-hidden rows has been passed
+    auto extendRange = [this, rowCount](int row, int step, int visibleRows) {
+        int r = row;
+        while (visibleRows > 0 && r + step >= 0 && r + step < rowCount) {
+            r += step;
+            if (!listWidget->item(r)->isHidden()) visibleRows--;
         }
+        return r;
+    };
 
-        bool visible = matchRepo && matchText;
-        item->setHidden(!visible);
-        if (visible) visibleCount++;
+    const int margin = qMax(0, SettingsDialog::getHydrationPrefetchRows());
+    const int hydrateFrom = extendRange(firstVisible, -1, margin);
+    const int hydrateTo = extendRange(lastVisible, 1, margin);
+    const int keepFrom = extendRange(hydrateFrom, -1, kHydrationKeepRows);
+    const int keepTo = extendRange(hydrateTo, 1, kHydrationKeepRows);
+
+    QSet<QString> keep;
+    for (int r = keepFrom; r <= keepTo && r < rowCount; ++r) {
+        QListWidgetItem* item = listWidget->item(r);
+        if (item == loadMoreItem || item->isHidden()) continue;
+
+        QString id = item->data(Qt::UserRole + 1).toString();
+        if (id.isEmpty()) continue;
+        keep.insert(id);
+
+        if (r < hydrateFrom || r > hydrateTo || m_hydrationInFlight.contains(id)) continue;
+        if (m_mutedThreads.contains(id)) continue;
+
+        auto detailsIt = detailsCache.constFind(id);
+        if (detailsIt != detailsCache.constEnd() && isHydrationFresh(*detailsIt)) continue;
+
+        QString url = item->data(Qt::UserRole).toString();
+        if (url.isEmpty()) continue;
+
+        m_hydrationInFlight.insert(id);
+        emit requestDetails(url, id);
+    }
+
+    // Rows scrolled well away from the viewport no longer need their answers
+    for (auto it = m_hydrationInFlight.begin(); it != m_hydrationInFlight.end();) {
+        if (keep.contains(*it)) {
+            ++it;
+            continue;
+        }
+        emit cancelDetails(*it);
+        it = m_hydrationInFlight.erase(it);
     }
+}
+
+bool NotificationListWidget::isHydrationFresh(const NotificationDetails& details) {
+    if (!details.fetchedAt.isValid()) return false;
+    qint64 age = details.fetchedAt.secsTo(QDateTime::currentDateTimeUtc());
+    return age < (details.hasDetails ? kDetailsTtlSecs : kDetailsRetrySecs);
+}
 
-    emit statusMessage(tr("Items: %1").arg(visibleCount));
+void NotificationListWidget::loadDetailsCache() {
+    QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/notification_details.json";
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        QJsonObject obj = it.value().toObject();
+
+        NotificationDetails details;
+        details.author = obj["author"].toString();
+        details.avatarUrl = obj["avatarUrl"].toString();
+        details.htmlUrl = obj["htmlUrl"].toString();
+        details.fetchedAt = QDateTime::fromString(obj["fetchedAt"].toString(), Qt::ISODate);
+        details.hasDetails = true;
+
+        // Expired entries are kept for display (notably for a warm start); hydration still refreshes them, and
+        // the next save drops any that were not
+        detailsCache.insert(it.key(), details);
+    }
+}
+
+void NotificationListWidget::scheduleDetailsCacheSave() { m_detailsSaveTimer->start(); }
+
+void NotificationListWidget::saveDetailsCache() {
+    m_detailsSaveTimer->stop();
+
+    QJsonObject root;
+    for (auto it = detailsCache.constBegin(); it != detailsCache.constEnd(); ++it) {
+        const NotificationDetails& details = it.value();
+        if (!details.hasDetails || !isHydrationFresh(details)) continue;
+
+        QJsonObject obj;
+        obj["author"] = details.author;
+        obj["avatarUrl"] = details.avatarUrl;
+        obj["htmlUrl"] = details.htmlUrl;
+        obj["fetchedAt"] = details.fetchedAt.toString(Qt::ISODate);
+        root[it.key()] = obj;
+    }
+
+    QString dirPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir dir(dirPath);
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    QFile file(dirPath + "/notification_details.json");
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        file.close();
+    }
 }
 
 NotificationItemWidget* NotificationListWidget::findNotificationWidget(const QString& id) {
@@ -858,8 +1205,8 @@ void NotificationListWidget::dismissCurrentItem() {
     for (const auto& child : n.groupedNotifications) {
         emit markAsDone(child.id);
     }
-    knownNotificationIds.remove(id);
-    removeKnownNotification(id);
+    m_store->removeNotification(id);
+    m_knownStore->remove(id);
 
     delete listWidget->takeItem(listWidget->row(item));
 }
@@ -882,6 +1229,7 @@ void NotificationListWidget::markAsReadAndRemoveItem(QListWidgetItem* item) {
     QString id = item->data(Qt::UserRole + 1).toString();
 
     emit markAsRead(id);
+    m_store->setUnread(id, false);
 
     QJsonObject json = item->data(Qt::UserRole + 4).toJsonObject();
     Notification n = Notification::fromJson(json);
@@ -908,7 +1256,7 @@ void NotificationListWidget::markAsReadAndRemoveItem(QListWidgetItem* item) {
 }
 
 void NotificationListWidget::openUrlForItem(QListWidgetItem* item) {
-    if (!item) return;
+    if (!item || isGroupHeader(item)) return;
 
     NotificationItemWidget* widget = qobject_cast<NotificationItemWidget*>(listWidget->itemWidget(item));
     if (widget && widget->isLoading()) return;
@@ -924,7 +1272,7 @@ void NotificationListWidget::openUrlForItem(QListWidgetItem* item) {
 }
 
 void NotificationListWidget::openWindowForItem(QListWidgetItem* item) {
-    if (!item) return;
+    if (!item || isGroupHeader(item)) return;
 
     NotificationItemWidget* widget = qobject_cast<NotificationItemWidget*>(listWidget->itemWidget(item));
     if (widget && widget->isLoading()) return;
@@ -960,10 +1308,11 @@ void NotificationListWidget::openWindowForItem(QListWidgetItem* item) {
                     // If not found in the visible list, we can at least emit the signal
                     if (actionName == "markAsRead") {
                         emit markAsRead(id);
+                        m_store->setUnread(id, false);
                     } else if (actionName == "markAsDone") {
                         emit markAsDone(id);
-                        knownNotificationIds.remove(id);
-                        removeKnownNotification(id);
+                        m_store->removeNotification(id);
+                        m_knownStore->remove(id);
                     }
                 }
             });
@@ -981,14 +1330,7 @@ void NotificationListWidget::copyLinkCurrentItem() {
 }
 
 QList<Notification> NotificationListWidget::getUnreadNotifications(int limit) const {
-    QList<Notification> unread;
-    for (const auto& n : m_allNotifications) {
-        if (n.unread) {
-            unread.append(n);
-            if (unread.count() >= limit) break;
-        }
-    }
-    return unread;
+    return m_store->unreadNotifications(limit);
 }
 
 void NotificationListWidget::resetLoadMoreState() {
@@ -1000,47 +1342,3 @@ void NotificationListWidget::resetLoadMoreState() {
         btn->setText(tr("Retry Load More"));
     }
 }
-
-void NotificationListWidget::loadKnownNotifications() {
-    if (SettingsDialog::getNotifyOnce()) {
-        QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/known_notifications";
-        QDir dir(path);
-
-        if (dir.exists()) {
-            QStringList files = dir.entryList(QDir::Files);
-            for (const QString& file : files) {
-                knownNotificationIds.insert(file);
-            }
-        }
-    } else {
-        knownNotificationIds.clear();
-    }
-}
-
-void NotificationListWidget::addKnownNotification(const QString& id) {
-    if (SettingsDialog::getNotifyOnce() && !id.isEmpty()) {
-        QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/known_notifications";
-        QDir dir(path);
-        if (!dir.exists()) {
-            dir.mkpath(".");
-        }
-
-        QFile file(path + "/" + id);
-        if (file.open(QIODevice::WriteOnly)) {
-            // Store timestamp as file content just in case it's needed later
-            QString timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
-            file.write(timestamp.toUtf8());
-            file.close();
-        }
-    }
-}
-
-void NotificationListWidget::removeKnownNotification(const QString& id) {
-    if (SettingsDialog::getNotifyOnce() && !id.isEmpty()) {
-        QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/known_notifications";
-        QFile file(path + "/" + id);
-        if (file.exists()) {
-            file.remove();
-        }
-    }
-}
@@ -1,30 +1,61 @@
 #ifndef NOTIFICATIONLISTWIDGET_H
 #define NOTIFICATIONLISTWIDGET_H
 
+#include <QDateTime>
 #include <QList>
 #include <QListWidget>
 #include <QMap>
 #include <QMenu>
+#include <QMultiHash>
 #include <QPixmap>
 #include <QSet>
+#include <QTimer>
 #include <QUrl>
 #include <QWidget>
 #include <QtGui/QAction>
 
 #include "Notification.h"
+#include "NotificationSorter.h"
 #include "SettingsDialog.h"
 
 class NotificationItemWidget;
+class KnownNotificationStore;
+class QLabel;
+class NotificationStore;
+class NotificationViewPipeline;
+struct NotificationView;
+struct NotificationGroup;
+class UpdateCoalescer;
 
 class NotificationListWidget : public QWidget {
     Q_OBJECT
    public:
     explicit NotificationListWidget(QWidget* parent = nullptr);
+    ~NotificationListWidget() override;
 
     void setClient(GitHubClient* client) { m_client = client; }
+    NotificationStore* store() const { return m_store; }
     void setNotifications(const QList<Notification>& notifications, bool append, bool hasMore);
+    // Muted threads are listed but their details are never fetched
+    void setMutedThreads(const QSet<QString>& ids) { m_mutedThreads = ids; }
+    // Shows a saved list, marked as stale, without counting anything as new. Details are not fetched for it
+    // until a fetch replaces it or confirmSnapshot() says it is still current.
+    void restoreSnapshot(const QList<Notification>& notifications, const QDateTime& savedAt);
+    void confirmSnapshot(bool hasMore);
+    bool isStale() const { return m_staleSince.isValid(); }
+    bool hasMore() const { return m_hasMore; }
+    // Avatar URLs of the rows' authors, for persisting alongside a snapshot
+    QStringList avatarUrls() const;
+    // While the window is hidden for long, the rows and their widgets are dropped and only the store is kept.
+    // Counts keep being reported; restoreViews() rebuilds the rows.
+    void releaseViews();
+    void restoreViews();
+    bool isReleased() const { return m_viewsReleased; }
+    void dismissAll();
     void setFilterMode(int mode);  // 0: Inbox, 1: Unread, 2: Read
     void setSortMode(int mode);
+    void setCustomSortKeys(const QString& spec);
+    void setGroupMode(int mode);  // NotificationGroupMode
     void setRepoFilter(const QString& repo);
     void setSearchFilter(const QString& text);
 
@@ -39,7 +70,9 @@ class NotificationListWidget : public QWidget {
         SortTypeAsc,
         SortTypeDesc,
         SortLastReadDesc,
-        SortLastReadAsc
+        SortLastReadAsc,
+        SortRepoReasonUpdated,
+        SortCustom
     };
 
     void selectAll();
@@ -52,6 +85,7 @@ class NotificationListWidget : public QWidget {
     // Getters for filters
     QStringList getAvailableRepos() const;
     int count() const;
+    const QList<Notification>& allNotifications() const;
     QList<Notification> getUnreadNotifications(int limit = 5) const;
 
    protected:
@@ -59,7 +93,6 @@ class NotificationListWidget : public QWidget {
 
    public slots:
     void updateDetails(const QString& id, const QString& author, const QString& avatarUrl, const QString& htmlUrl);
-    void updateImage(const QString& id, const QPixmap& pixmap);
     void updateError(const QString& id, const QString& error);
     void resetLoadMoreState();
 
@@ -73,8 +106,9 @@ class NotificationListWidget : public QWidget {
     void loadMoreRequested();
     void notificationActivated(const QString& id);
     void requestDetails(const QString& url, const QString& id);
-    void requestImage(const QString& url, const QString& id);
+    void cancelDetails(const QString& id);
     void requestDebugApi(const QString& url);
+    void repoFilterRequested(const QString& repo);
 
    private slots:
     void onListContextMenu(const QPoint& pos);
@@ -88,16 +122,37 @@ class NotificationListWidget : public QWidget {
 
     struct NotificationDetails {
         QString author;
-        QString avatarUrl;
+        QString avatarUrl;  // Handle into AvatarStore; the image itself is shared by every row of the same author
         QString htmlUrl;
-        QPixmap avatar;
+        QDateTime fetchedAt;  // Last details response (or error), drives the hydration TTL
         bool hasDetails = false;
-        bool hasImage = false;
     };
 
+    // Detail hydration follows the viewport: only rows on screen plus a prefetch margin are fetched
+    void scheduleHydration();
+    void hydrateVisibleRows();
+    static bool isHydrationFresh(const NotificationDetails& details);
+    void loadDetailsCache();
+    void scheduleDetailsCacheSave();
+    void saveDetailsCache();
+    void setStaleSince(const QDateTime& savedAt);
+
     void insertNotificationItem(int row, const Notification& n);
+    QPixmap avatarFor(const QString& id, const QString& avatarUrl);
+    void onAvatarReady(const QString& url, const QPixmap& pixmap);
+    void onCoalescedUpdate(int mergedCount);
     void updateList();
-    void applyClientFilters();
+    void applyView(const NotificationView& view);
+
+    // Grouped view: header rows carry the group key, collapsed groups have no member rows at all
+    static QString groupRowKey(const QString& groupKey);
+    static QString rowKey(QListWidgetItem* item);
+    static bool isGroupHeader(QListWidgetItem* item);
+    void insertGroupHeader(int row, const NotificationGroup& group);
+    void updateGroupHeader(QListWidgetItem* item, const NotificationGroup& group);
+    void setGroupExpanded(const QString& key, bool expanded);
+    void setAllGroupsExpanded(bool expanded);
+    void onGroupContextMenu(QListWidgetItem* item, const QPoint& globalPos);
     NotificationItemWidget* findNotificationWidget(const QString& id);
     void dismissCurrentItem();
     void openUrlCurrentItem();
@@ -108,23 +163,39 @@ class NotificationListWidget : public QWidget {
     void markAsReadAndRemoveItem(QListWidgetItem* item);
 
     QListWidget* listWidget;
-    QList<Notification> m_allNotifications;
+    QLabel* m_staleBanner;
+    QDateTime m_staleSince;
+    NotificationStore* m_store;
     QMap<QString, NotificationDetails> detailsCache;
-    QSet<QString> knownNotificationIds;
-    void loadKnownNotifications();
-    void addKnownNotification(const QString& id);
-    void removeKnownNotification(const QString& id);
+    QSet<QString> m_hydrationInFlight;
+    QSet<QString> m_mutedThreads;
+    QMultiHash<QString, QString> m_avatarWaiters;  // Avatar URL -> ids of rows still showing no picture
+    QTimer* m_hydrationTimer;
+    QTimer* m_detailsSaveTimer;
+    KnownNotificationStore* m_knownStore;
     QListWidgetItem* loadMoreItem;
 
     // Filters
     int m_filterMode;
     SortMode m_sortMode;
+    QList<NotificationSorter::SortKey> m_sortKeys;
+    NotificationViewPipeline* m_viewPipeline;
+    int m_groupMode;
+    QSet<QString> m_expandedGroups;
+    QStringList m_groupKeys;
+    QString m_pendingFocusId;
+    QString m_customSortKeys;
+    QList<NotificationSorter::SortKey> sortCriteriaFor(SortMode mode) const;
     QString m_repoFilter;
     QString m_searchFilter;
     bool m_hasMore;
     int m_pendingNewNotifications;
     QList<Notification> m_pendingNewlyAddedNotifications;
     bool m_countsDirty;
+    UpdateCoalescer* m_updateCoalescer;
+    int m_mergedUpdates;  // Changes the coalescer folded into the rebuild that is on its way
+    bool m_modelChanged;
+    bool m_viewsReleased;
 
     // Context Menu
     GitHubClient* m_client;
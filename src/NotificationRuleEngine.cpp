@@ -1,7 +1,34 @@
 #include "NotificationRuleEngine.h"
 
-#include <QRegularExpression>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
 #include <QStringList>
+#include <QStringView>
+
+namespace {
+// Only one check in this many per rule is timed, and counted this many times over; a power of two
+const quint64 kTimingSampleRate = 16;
+
+// Guards the compiled set and the accumulated stats
+QMutex s_compiledMutex;
+QSharedPointer<const NotificationRuleSet> s_compiledRules;
+QHash<QString, RuleStats> s_stats;
+bool s_statsLoaded = false;
+bool s_statsDirty = false;
+
+QString statsPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/rule_stats.tsv";
+}
+}  // namespace
 
 QJsonObject NotificationRule::toJson() const {
     QJsonObject obj;
@@ -10,6 +37,10 @@ QJsonObject NotificationRule::toJson() const {
     obj["reasonFilter"] = reasonFilter;
     obj["titleFilter"] = titleFilter;
     obj["action"] = action;
+    // Written only when set, so rules without them keep their key (and stats) from before these existed
+    if (hideFromList) obj["hideFromList"] = true;
+    if (!serverAction.isEmpty()) obj["serverAction"] = serverAction;
+    if (unsubscribe) obj["unsubscribe"] = true;
     return obj;
 }
 
@@ -20,6 +51,9 @@ NotificationRule NotificationRule::fromJson(const QJsonObject& obj) {
     rule.reasonFilter = obj["reasonFilter"].toString();
     rule.titleFilter = obj["titleFilter"].toString();
     rule.action = obj["action"].toString();
+    rule.hideFromList = obj["hideFromList"].toBool();
+    rule.serverAction = obj["serverAction"].toString();
+    rule.unsubscribe = obj["unsubscribe"].toBool();
 
     // Backwards compatibility for the string based "condition"
     if (obj.contains("condition")) {
@@ -51,35 +85,249 @@ QString NotificationRule::displayCondition() const {
     return parts.join(" | ");
 }
 
-bool NotificationRule::matches(const Notification& n) const {
-    auto matchField = [](const QString& filter, const QString& value, bool isWildcard = false) -> bool {
-        if (filter.isEmpty()) return true;  // Empty filter means it matches anything
+QString NotificationRule::displayAction() const {
+    if (action != "Mute") return action;
 
-        bool isNegative = filter.startsWith("!");
-        QString actualFilter = isNegative ? filter.mid(1) : filter;
+    QStringList extras;
+    if (hideFromList) extras << "hide";
+    if (serverAction == "MarkRead") extras << "mark read";
+    if (serverAction == "MarkDone") extras << "mark done";
+    if (unsubscribe) extras << "unsubscribe";
+    return extras.isEmpty() ? action : QString("%1 (%2)").arg(action, extras.join(", "));
+}
+
+NotificationRuleSet::NotificationRuleSet(const QList<NotificationRule>& rules) : m_trie(1) {
+    for (int i = 0; i < rules.size(); ++i) {
+        const NotificationRule& source = rules.at(i);
+        m_sources.append(source);
+        m_keys.append(NotificationRuleEngine::ruleKey(source));
+        if (source.action == "Default") {
+            m_positions.append(-1);
+            continue;
+        }
 
-        bool isMatch = false;
-        if (isWildcard) {
-            QRegularExpression rx(QRegularExpression::wildcardToRegularExpression(actualFilter),
-                                  QRegularExpression::CaseInsensitiveOption);
-            isMatch = rx.match(value).hasMatch();
+        Rule rule;
+        rule.index = i;
+        rule.repo = compileRepo(source.repoFilter);
+        rule.type = compileText(source.typeFilter);
+        rule.reason = compileText(source.reasonFilter);
+        rule.title = compileText(source.titleFilter);
+
+        int position = m_rules.size();
+        m_rules.append(rule);
+        m_positions.append(position);
+
+        if (rule.repo.negated || rule.repo.kind == RepoFilter::Any || rule.repo.kind == RepoFilter::Pattern) {
+            m_unindexed.append(position);
+        } else if (rule.repo.kind == RepoFilter::Exact) {
+            m_trie[addTrieNode(rule.repo.text)].exact.append(position);
         } else {
-            isMatch = value.contains(actualFilter, Qt::CaseInsensitive);
-            // exact match for type/reason if not using wildcard logic natively
-            if (actualFilter.compare(value, Qt::CaseInsensitive) == 0) {
-                isMatch = true;
-            }
+            m_trie[addTrieNode(rule.repo.text)].prefix.append(position);
         }
+    }
+    m_counters = std::vector<Counters>(m_rules.size());
+}
+
+int NotificationRuleSet::match(const Notification& n) const {
+    // Each candidate list is in priority order, so the earliest match across all of them is the first match
+    // a plain scan over every rule would have found
+    int best = m_rules.size();
+    scan(m_unindexed, n, best);
 
-        return isNegative ? !isMatch : isMatch;
+    int node = 0;
+    scan(m_trie.at(0).prefix, n, best);
+    for (QChar c : n.repository) {
+        node = trieChild(node, c.toLower().unicode());
+        if (node < 0) break;
+        scan(m_trie.at(node).prefix, n, best);
+    }
+    if (node >= 0) scan(m_trie.at(node).exact, n, best);
+
+    if (best == m_rules.size()) return -1;
+
+    // A later candidate can match too without deciding anything, so only the winner counts as a match
+    Counters& counters = m_counters[best];
+    counters.matches.fetchAndAddRelaxed(1);
+    counters.lastMatchSecs.storeRelaxed(QDateTime::currentSecsSinceEpoch());
+    return m_rules.at(best).index;
+}
+
+void NotificationRuleSet::scan(const QList<int>& positions, const Notification& n, int& best) const {
+    for (int position : positions) {
+        if (position >= best) return;
+
+        Counters& counters = m_counters[position];
+        bool matched;
+        if ((counters.evaluations.fetchAndAddRelaxed(1) & (kTimingSampleRate - 1)) == 0) {
+            QElapsedTimer timer;
+            timer.start();
+            matched = matches(m_rules.at(position), n);
+            counters.totalNs.fetchAndAddRelaxed(timer.nsecsElapsed() * qint64(kTimingSampleRate));
+        } else {
+            matched = matches(m_rules.at(position), n);
+        }
+
+        if (matched) {
+            best = position;
+            return;
+        }
+    }
+}
+
+int NotificationRuleSet::trieChild(int node, char16_t c) const {
+    for (const auto& child : m_trie.at(node).children) {
+        if (child.first == c) return child.second;
+    }
+    return -1;
+}
+
+int NotificationRuleSet::addTrieNode(const QString& text) {
+    int node = 0;
+    for (QChar c : text) {
+        char16_t key = c.toLower().unicode();
+        int next = trieChild(node, key);
+        if (next < 0) {
+            next = m_trie.size();
+            m_trie.append(TrieNode());
+            m_trie[node].children.append(qMakePair(key, next));
+        }
+        node = next;
+    }
+    return node;
+}
+
+RuleSimulation NotificationRuleSet::simulate(const QList<Notification>& notifications) const {
+    RuleSimulation result;
+    result.decisions.reserve(notifications.size());
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const Notification& n : notifications) {
+        result.decisions.append(match(n));
+    }
+    result.totalNs = timer.nsecsElapsed();
+
+    for (int ruleIndex : result.decisions) {
+        QString action = actionAt(ruleIndex);
+        if (action == "Mute") {
+            result.muted++;
+        } else if (action == "AlwaysIndividual") {
+            result.individual++;
+        } else if (action == "NeverIndividual" || action == "AlwaysSummarize") {
+            result.summarized++;
+        } else {
+            result.unmatched++;
+        }
+    }
+    return result;
+}
+
+QString NotificationRuleSet::actionAt(int ruleIndex) const {
+    return ruleIndex >= 0 && ruleIndex < m_sources.size() ? m_sources.at(ruleIndex).action : QStringLiteral("Default");
+}
+
+RuleStats NotificationRuleSet::statsAt(int ruleIndex) const {
+    RuleStats stats;
+    int position = ruleIndex >= 0 && ruleIndex < m_positions.size() ? m_positions.at(ruleIndex) : -1;
+    if (position < 0) return stats;
+
+    const Counters& counters = m_counters[position];
+    stats.evaluations = counters.evaluations.loadRelaxed();
+    stats.matches = counters.matches.loadRelaxed();
+    stats.lastMatchSecs = counters.lastMatchSecs.loadRelaxed();
+    stats.totalNs = counters.totalNs.loadRelaxed();
+    return stats;
+}
+
+bool NotificationRuleSet::drainStats(QHash<QString, RuleStats>& into) const {
+    bool drained = false;
+    for (int i = 0; i < m_positions.size(); ++i) {
+        int position = m_positions.at(i);
+        if (position < 0) continue;
+
+        Counters& counters = m_counters[position];
+        quint64 evaluations = counters.evaluations.fetchAndStoreRelaxed(0);
+        if (evaluations == 0) continue;
+        drained = true;
+
+        RuleStats& stats = into[m_keys.at(i)];
+        stats.evaluations += evaluations;
+        stats.matches += counters.matches.fetchAndStoreRelaxed(0);
+        stats.totalNs += counters.totalNs.fetchAndStoreRelaxed(0);
+        stats.lastMatchSecs = qMax(stats.lastMatchSecs, counters.lastMatchSecs.loadRelaxed());
+    }
+    return drained;
+}
+
+NotificationRuleSet::TextFilter NotificationRuleSet::compileText(const QString& filter) {
+    TextFilter compiled;
+    if (filter.isEmpty()) return compiled;  // Empty filter means it matches anything
+
+    compiled.active = true;
+    compiled.negated = filter.startsWith('!');
+    compiled.text = compiled.negated ? filter.mid(1) : filter;
+    return compiled;
+}
+
+NotificationRuleSet::RepoFilter NotificationRuleSet::compileRepo(const QString& filter) {
+    RepoFilter compiled;
+    if (filter.isEmpty()) return compiled;
+
+    compiled.negated = filter.startsWith('!');
+    QString actual = compiled.negated ? filter.mid(1) : filter;
+
+    auto isPlain = [](QStringView text) {
+        for (QChar c : text) {
+            if (c == '*' || c == '?' || c == '[' || c == '\\') return false;
+        }
+        return true;
     };
 
-    if (!matchField(repoFilter, n.repository, true)) return false;
-    if (!matchField(typeFilter, n.type)) return false;
-    if (!matchField(reasonFilter, n.reason)) return false;
-    if (!matchField(titleFilter, n.title)) return false;
+    if (isPlain(actual)) {
+        compiled.kind = RepoFilter::Exact;
+        compiled.text = actual;
+    } else if (actual.endsWith('*') && isPlain(QStringView(actual).chopped(1))) {
+        // "owner/*": the wildcard stops at '/', exactly like the pattern form below
+        compiled.kind = RepoFilter::Prefix;
+        compiled.text = actual.chopped(1);
+    } else {
+        compiled.kind = RepoFilter::Pattern;
+        compiled.pattern = QRegularExpression(QRegularExpression::wildcardToRegularExpression(actual),
+                                              QRegularExpression::CaseInsensitiveOption);
+        compiled.pattern.optimize();
+    }
+    return compiled;
+}
+
+bool NotificationRuleSet::matchesText(const TextFilter& filter, const QString& value) {
+    if (!filter.active) return true;
+    // A case-insensitive substring match also covers the exact type/reason names
+    bool isMatch = value.contains(filter.text, Qt::CaseInsensitive);
+    return filter.negated ? !isMatch : isMatch;
+}
+
+bool NotificationRuleSet::matchesRepo(const RepoFilter& filter, const QString& repository) {
+    bool isMatch = false;
+    switch (filter.kind) {
+        case RepoFilter::Any:
+            return true;
+        case RepoFilter::Exact:
+            isMatch = repository.compare(filter.text, Qt::CaseInsensitive) == 0;
+            break;
+        case RepoFilter::Prefix:
+            isMatch = repository.startsWith(filter.text, Qt::CaseInsensitive) &&
+                      !QStringView(repository).mid(filter.text.size()).contains(u'/');
+            break;
+        case RepoFilter::Pattern:
+            isMatch = filter.pattern.match(repository).hasMatch();
+            break;
+    }
+    return filter.negated ? !isMatch : isMatch;
+}
 
-    return true;
+bool NotificationRuleSet::matches(const Rule& rule, const Notification& n) {
+    return matchesRepo(rule.repo, n.repository) && matchesText(rule.type, n.type) &&
+           matchesText(rule.reason, n.reason) && matchesText(rule.title, n.title);
 }
 
 QList<NotificationRule> NotificationRuleEngine::loadRules() {
@@ -105,18 +353,57 @@ void NotificationRuleEngine::saveRules(const QList<NotificationRule>& rules) {
         list.append(QString::fromUtf8(doc.toJson(QJsonDocument::Compact)));
     }
     settings.setValue("rules", list);
+
+    // Holders of the old set keep it alive; the next evaluation compiles the new rules
+    QMutexLocker locker(&s_compiledMutex);
+    loadStatsLocked();
+    if (s_compiledRules) s_compiledRules->drainStats(s_stats);
+    s_compiledRules.reset();
+
+    // Stats of deleted rules would otherwise stay in the file forever
+    QSet<QString> keys;
+    for (const NotificationRule& rule : rules) {
+        keys.insert(ruleKey(rule));
+    }
+    for (auto it = s_stats.begin(); it != s_stats.end();) {
+        it = keys.contains(it.key()) ? std::next(it) : s_stats.erase(it);
+    }
+    s_statsDirty = true;
+}
+
+QSharedPointer<const NotificationRuleSet> NotificationRuleEngine::compiledRules() {
+    QMutexLocker locker(&s_compiledMutex);
+    if (!s_compiledRules) {
+        s_compiledRules = QSharedPointer<const NotificationRuleSet>::create(loadRules());
+    }
+    return s_compiledRules;
 }
 
 QString NotificationRuleEngine::evaluate(const Notification& n) {
-    QList<NotificationRule> rules = loadRules();
-    for (const NotificationRule& rule : rules) {
-        if (rule.matches(n)) {
-            if (rule.action != "Default") {
-                return rule.action;
+    QSharedPointer<const NotificationRuleSet> rules = compiledRules();
+    return rules->actionAt(rules->match(n));
+}
+
+QList<RuleDecision> NotificationRuleEngine::evaluateBatch(const QList<Notification>& notifications) {
+    QSharedPointer<const NotificationRuleSet> rules = compiledRules();
+
+    QList<RuleDecision> decisions;
+    decisions.reserve(notifications.size());
+    for (const Notification& n : notifications) {
+        RuleDecision decision;
+        decision.ruleIndex = rules->match(n);
+        if (decision.ruleIndex >= 0) {
+            const NotificationRule& rule = rules->ruleAt(decision.ruleIndex);
+            decision.action = rule.action;
+            if (rule.action == "Mute") {
+                decision.hideFromList = rule.hideFromList;
+                decision.serverAction = rule.serverAction;
+                decision.unsubscribe = rule.unsubscribe;
             }
         }
+        decisions.append(decision);
     }
-    return "Default";
+    return decisions;
 }
 
 void NotificationRuleEngine::addRule(const NotificationRule& rule) {
@@ -130,3 +417,75 @@ void NotificationRuleEngine::prependRule(const NotificationRule& rule) {
     rules.prepend(rule);
     saveRules(rules);
 }
+
+QString NotificationRuleEngine::ruleKey(const NotificationRule& rule) {
+    return QString::fromUtf8(QJsonDocument(rule.toJson()).toJson(QJsonDocument::Compact));
+}
+
+RuleStats NotificationRuleEngine::statsFor(const NotificationRule& rule) {
+    QMutexLocker locker(&s_compiledMutex);
+    loadStatsLocked();
+    if (s_compiledRules && s_compiledRules->drainStats(s_stats)) s_statsDirty = true;
+    return s_stats.value(ruleKey(rule));
+}
+
+void NotificationRuleEngine::resetStats() {
+    QMutexLocker locker(&s_compiledMutex);
+    s_statsLoaded = true;
+    s_stats.clear();
+    if (s_compiledRules) {
+        QHash<QString, RuleStats> discarded;
+        s_compiledRules->drainStats(discarded);
+    }
+    s_statsDirty = true;
+    locker.unlock();
+
+    flushStats();
+}
+
+void NotificationRuleEngine::flushStats() {
+    QMutexLocker locker(&s_compiledMutex);
+    loadStatsLocked();
+    if (s_compiledRules && s_compiledRules->drainStats(s_stats)) s_statsDirty = true;
+    if (!s_statsDirty) return;
+    s_statsDirty = false;
+
+    QByteArray data;
+    for (auto it = s_stats.constBegin(); it != s_stats.constEnd(); ++it) {
+        const RuleStats& stats = it.value();
+        data += it.key().toUtf8() + '\t' + QByteArray::number(stats.evaluations) + '\t' +
+                QByteArray::number(stats.matches) + '\t' + QByteArray::number(stats.lastMatchSecs) + '\t' +
+                QByteArray::number(stats.totalNs) + '\n';
+    }
+    locker.unlock();
+
+    QString path = statsPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write rule stats" << path << file.errorString();
+        return;
+    }
+    file.write(data);
+    file.commit();
+}
+
+void NotificationRuleEngine::loadStatsLocked() {
+    if (s_statsLoaded) return;
+    s_statsLoaded = true;
+
+    // One line per rule: compact rule JSON, evaluations, matches, last match, nanoseconds (tab separated)
+    QFile file(statsPath());
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    while (!file.atEnd()) {
+        QList<QByteArray> fields = file.readLine().trimmed().split('\t');
+        if (fields.size() != 5) continue;
+
+        RuleStats& stats = s_stats[QString::fromUtf8(fields.at(0))];
+        stats.evaluations += fields.at(1).toULongLong();
+        stats.matches += fields.at(2).toULongLong();
+        stats.lastMatchSecs = qMax(stats.lastMatchSecs, fields.at(3).toLongLong());
+        stats.totalNs += fields.at(4).toLongLong();
+    }
+}
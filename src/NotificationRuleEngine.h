@@ -1,12 +1,19 @@
 #ifndef NOTIFICATIONRULEENGINE_H
 #define NOTIFICATIONRULEENGINE_H
 
+#include <QAtomicInteger>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QList>
+#include <QPair>
+#include <QRegularExpression>
 #include <QSettings>
+#include <QSharedPointer>
 #include <QString>
+#include <QStringList>
+#include <vector>
 
 #include "Notification.h"
 
@@ -19,21 +26,147 @@ class NotificationRule {
 
     QString action;  // "Mute", "AlwaysIndividual", "NeverIndividual", "AlwaysSummarize", "Default"
 
+    // Only used by "Mute": applied as notifications arrive, before they reach the list
+    bool hideFromList = false;
+    QString serverAction;  // "", "MarkRead" or "MarkDone"
+    bool unsubscribe = false;
+
     QJsonObject toJson() const;
     static NotificationRule fromJson(const QJsonObject& obj);
-    bool matches(const Notification& n) const;
 
     QString displayCondition() const;
+    QString displayAction() const;
+};
+
+// How often a rule was checked and how often it decided the outcome
+struct RuleStats {
+    quint64 evaluations = 0;
+    quint64 matches = 0;
+    qint64 lastMatchSecs = 0;  // Seconds since epoch, 0 if never
+    qint64 totalNs = 0;        // Time spent checking the rule, estimated from a sample of the checks
+};
+
+// What a rule set would do with a list of notifications, without acting on any of them
+struct RuleSimulation {
+    QList<int> decisions;  // Deciding rule index per notification, -1 when none matched
+    int muted = 0;
+    int individual = 0;
+    int summarized = 0;  // "NeverIndividual" and "AlwaysSummarize"
+    int unmatched = 0;   // Left to the summary threshold
+    qint64 totalNs = 0;
+};
+
+// Rules with their filters parsed once: negation is split off and repo wildcards are reduced to an exact name,
+// a "prefix*" form or, failing those, a precompiled regular expression. Matching does no parsing and, outside
+// of unusual wildcards, no allocation. Rules whose action is "Default" can never decide an outcome and are dropped.
+//
+// Exact and "prefix*" repo filters are indexed in a case-insensitive trie, so a notification is only checked
+// against the rules for its own repository plus the ones the trie cannot hold (negated or pattern repo
+// filters, or no repo filter at all). Type, reason and title filters are substring matches and stay unindexed.
+class NotificationRuleSet {
+   public:
+    explicit NotificationRuleSet(const QList<NotificationRule>& rules = QList<NotificationRule>());
+
+    // Index (into the list the set was built from) of the first deciding rule that matches, or -1
+    int match(const Notification& n) const;
+    // Matches every notification in order and totals the outcomes; the checks count towards statsAt()
+    RuleSimulation simulate(const QList<Notification>& notifications) const;
+    QString actionAt(int ruleIndex) const;
+    const NotificationRule& ruleAt(int ruleIndex) const { return m_sources.at(ruleIndex); }
+    bool isEmpty() const { return m_rules.isEmpty(); }
+
+    // Counters since the set was built or last drained; "Default" rules are never checked and stay at zero
+    RuleStats statsAt(int ruleIndex) const;
+    // Adds the counters to `into` by rule key and resets them; returns false if nothing was counted
+    bool drainStats(QHash<QString, RuleStats>& into) const;
+
+   private:
+    struct TextFilter {
+        QString text;
+        bool active = false;
+        bool negated = false;
+    };
+
+    struct RepoFilter {
+        enum Kind { Any, Exact, Prefix, Pattern };
+        Kind kind = Any;
+        QString text;  // Whole name for Exact, the part before '*' for Prefix
+        QRegularExpression pattern;
+        bool negated = false;
+    };
+
+    struct Rule {
+        int index = 0;
+        RepoFilter repo;
+        TextFilter type;
+        TextFilter reason;
+        TextFilter title;
+    };
+
+    static TextFilter compileText(const QString& filter);
+    static RepoFilter compileRepo(const QString& filter);
+    static bool matchesText(const TextFilter& filter, const QString& value);
+    static bool matchesRepo(const RepoFilter& filter, const QString& repository);
+    static bool matches(const Rule& rule, const Notification& n);
+
+    struct TrieNode {
+        QList<QPair<char16_t, int>> children;  // Lowercased character -> node
+        QList<int> exact;                       // Positions in m_rules, ascending
+        QList<int> prefix;
+    };
+
+    int trieChild(int node, char16_t c) const;
+    int addTrieNode(const QString& text);
+    void scan(const QList<int>& positions, const Notification& n, int& best) const;
+
+    // Updated from whichever thread evaluates, so every field is atomic
+    struct Counters {
+        QAtomicInteger<quint64> evaluations;
+        QAtomicInteger<quint64> matches;
+        QAtomicInteger<qint64> lastMatchSecs;
+        QAtomicInteger<qint64> totalNs;
+    };
+
+    QList<Rule> m_rules;
+    QList<TrieNode> m_trie;  // Root is node 0
+    QList<int> m_unindexed;
+    QList<NotificationRule> m_sources;  // The rules the set was built from, by source index
+    QStringList m_keys;     // NotificationRuleEngine::ruleKey() of every source rule
+    QList<int> m_positions;  // Source index -> position in m_rules, -1 for dropped rules
+    mutable std::vector<Counters> m_counters;  // By position in m_rules
+};
+
+struct RuleDecision {
+    QString action = QStringLiteral("Default");
+    int ruleIndex = -1;  // Index in loadRules() of the deciding rule, -1 when none matched
+    // Ingest-time handling of muted notifications, copied from the deciding rule
+    bool hideFromList = false;
+    QString serverAction;
+    bool unsubscribe = false;
 };
 
 class NotificationRuleEngine {
    public:
     static QList<NotificationRule> loadRules();
     static void saveRules(const QList<NotificationRule>& rules);
+    // The saved rules, compiled on first use and shared until the next save; safe to call from any thread
+    static QSharedPointer<const NotificationRuleSet> compiledRules();
 
     static QString evaluate(const Notification& n);
+    // One decision per input, in order, all against the same compiled rules; usable from a worker thread
+    static QList<RuleDecision> evaluateBatch(const QList<Notification>& notifications);
     static void addRule(const NotificationRule& rule);
     static void prependRule(const NotificationRule& rule);
+
+    // Stats are kept per rule content, so they follow a rule when it is moved and restart when it is edited
+    static QString ruleKey(const NotificationRule& rule);
+    static RuleStats statsFor(const NotificationRule& rule);
+    static void resetStats();
+    // Writes the accumulated stats to disk; callers batch this, it is a file write on the calling thread
+    static void flushStats();
+
+   private:
+    static void loadStatsLocked();
 };
 
 #endif  // NOTIFICATIONRULEENGINE_H
@@ -0,0 +1,94 @@
+#include "NotificationSnapshot.h"
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+const quint32 kMagic = 0x4b474e53;  // "KGNS"
+const quint32 kVersion = 1;
+
+void writeNotification(QDataStream& out, const Notification& n) {
+    out << n.id << n.title << n.type << n.repository << n.url << n.htmlUrl << n.updatedAt << n.lastReadAt << n.reason
+        << n.unread << QCborValue::fromJsonValue(n.rawJson).toCbor();
+    out << quint32(n.groupedNotifications.size());
+    for (const Notification& grouped : n.groupedNotifications) {
+        writeNotification(out, grouped);
+    }
+}
+
+bool readNotification(QDataStream& in, Notification& n, int depth = 0) {
+    QByteArray raw;
+    quint32 groupedCount = 0;
+    in >> n.id >> n.title >> n.type >> n.repository >> n.url >> n.htmlUrl >> n.updatedAt >> n.lastReadAt >>
+        n.reason >> n.unread >> raw >> groupedCount;
+    // Grouped notifications are only ever one level deep; anything else is a corrupt file
+    if (in.status() != QDataStream::Ok || (depth > 0 && groupedCount > 0)) return false;
+
+    n.rawJson = QCborValue::fromCbor(raw).toMap().toJsonObject();
+    for (quint32 i = 0; i < groupedCount; ++i) {
+        Notification grouped;
+        if (!readNotification(in, grouped, depth + 1)) return false;
+        n.groupedNotifications.append(grouped);
+    }
+    return true;
+}
+}  // namespace
+
+QString NotificationSnapshot::defaultPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/notifications.snapshot";
+}
+
+NotificationSnapshot NotificationSnapshot::load(const QString& path) {
+    NotificationSnapshot snapshot;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return snapshot;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        qDebug() << "Ignoring notification snapshot in an unknown format:" << path;
+        return snapshot;
+    }
+
+    NotificationSnapshot loaded;
+    in >> loaded.savedAt >> loaded.lastModified >> loaded.nextPageUrl >> count;
+    loaded.notifications.reserve(qMin<quint32>(count, 10000));
+    for (quint32 i = 0; i < count; ++i) {
+        Notification n;
+        if (!readNotification(in, n)) {
+            qWarning() << "Notification snapshot is truncated or corrupt, ignoring it:" << path;
+            return snapshot;
+        }
+        loaded.notifications.append(n);
+    }
+    return loaded;
+}
+
+bool NotificationSnapshot::save(const QString& path) const {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write notification snapshot" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kMagic << kVersion << savedAt << lastModified << nextPageUrl << quint32(notifications.size());
+    for (const Notification& n : notifications) {
+        writeNotification(out, n);
+    }
+    return file.commit();
+}
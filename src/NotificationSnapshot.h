@@ -0,0 +1,30 @@
+#ifndef NOTIFICATIONSNAPSHOT_H
+#define NOTIFICATIONSNAPSHOT_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+#include "Notification.h"
+
+// The last known notification list, written after each sync and on shutdown and read back at launch so the
+// list can be shown before the token and the first fetch are in.
+//
+// The file is a versioned QDataStream with each notification's raw API object stored as CBOR, which reads
+// back far faster than JSON text. The fetch validators are kept with it so the first refresh can be
+// conditional. A missing, truncated or older-format file loads as an empty snapshot.
+struct NotificationSnapshot {
+    QList<Notification> notifications;
+    QDateTime savedAt;
+    QByteArray lastModified;
+    QString nextPageUrl;
+
+    bool isEmpty() const { return notifications.isEmpty(); }
+
+    static QString defaultPath();
+    static NotificationSnapshot load(const QString& path);
+    bool save(const QString& path) const;
+};
+
+#endif  // NOTIFICATIONSNAPSHOT_H
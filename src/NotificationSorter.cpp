@@ -0,0 +1,147 @@
+#include "NotificationSorter.h"
+
+#include <QDateTime>
+#include <QStringList>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace {
+const char* const kFieldNames[] = {"repository", "title", "type", "reason", "updated", "lastread"};
+const int kFieldCount = sizeof(kFieldNames) / sizeof(kFieldNames[0]);
+// Repository, title, type and reason: the fields compared by collation key, indexed by their Field value
+const int kTextFieldCount = 4;
+
+qint64 parseTimestamp(const QString& iso) {
+    if (iso.isEmpty()) return std::numeric_limits<qint64>::min();
+    QDateTime dt = QDateTime::fromString(iso, Qt::ISODate);
+    return dt.isValid() ? dt.toSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+}
+
+int compareNumbers(qint64 a, qint64 b) { return (a > b) - (a < b); }
+}  // namespace
+
+NotificationSorter::NotificationSorter() {
+    m_collator.setCaseSensitivity(Qt::CaseInsensitive);
+    m_collator.setNumericMode(true);
+}
+
+void NotificationSorter::sort(QList<Notification>& notifications) {
+    if (m_criteria.isEmpty() || notifications.size() < 2) return;
+
+    // Fill the cache first; pointers into the hash are only stable once nothing else is inserted
+    for (const Notification& n : notifications) {
+        keysFor(n);
+    }
+    std::vector<const Keys*> keys;
+    keys.reserve(notifications.size());
+    for (const Notification& n : notifications) {
+        keys.push_back(&m_cache.find(n.id).value());
+    }
+
+    std::vector<int> order(notifications.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [this, &keys](int a, int b) { return compare(*keys[a], *keys[b]) < 0; });
+
+    QList<Notification> sorted;
+    sorted.reserve(notifications.size());
+    for (int index : order) {
+        sorted.append(notifications.at(index));
+    }
+    notifications = sorted;
+
+    // Drop keys for notifications that have gone away once they clearly outnumber the live ones
+    if (m_cache.size() > 2 * notifications.size() + 256) {
+        QHash<QString, Keys> live;
+        live.reserve(notifications.size());
+        for (const Notification& n : notifications) {
+            live.insert(n.id, m_cache.value(n.id));
+        }
+        m_cache.swap(live);
+    }
+}
+
+QList<NotificationSorter::SortKey> NotificationSorter::parseCriteria(const QString& spec) {
+    QList<SortKey> criteria;
+    const QStringList parts = spec.split(',', Qt::SkipEmptyParts);
+    for (QString part : parts) {
+        part = part.trimmed().toLower();
+        Qt::SortOrder order = Qt::AscendingOrder;
+        if (part.startsWith('-')) {
+            order = Qt::DescendingOrder;
+            part = part.mid(1);
+        } else if (part.startsWith('+')) {
+            part = part.mid(1);
+        }
+
+        for (int i = 0; i < kFieldCount; ++i) {
+            if (part == QLatin1String(kFieldNames[i])) {
+                criteria.append({static_cast<Field>(i), order});
+                break;
+            }
+        }
+    }
+    return criteria;
+}
+
+QString NotificationSorter::criteriaToString(const QList<SortKey>& criteria) {
+    QStringList parts;
+    for (const SortKey& key : criteria) {
+        QString name = QLatin1String(kFieldNames[key.field]);
+        parts << (key.order == Qt::DescendingOrder ? "-" + name : name);
+    }
+    return parts.join(',');
+}
+
+const NotificationSorter::Keys& NotificationSorter::keysFor(const Notification& n) {
+    auto it = m_cache.find(n.id);
+    if (it != m_cache.end()) {
+        Keys& cached = it.value();
+        if (cached.repository == n.repository && cached.title == n.title && cached.type == n.type &&
+            cached.reason == n.reason && cached.updatedAt == n.updatedAt && cached.lastReadAt == n.lastReadAt) {
+            return cached;
+        }
+    } else {
+        it = m_cache.insert(n.id, Keys());
+    }
+
+    Keys& keys = it.value();
+    keys.repository = n.repository;
+    keys.title = n.title;
+    keys.type = n.type;
+    keys.reason = n.reason;
+    keys.updatedAt = n.updatedAt;
+    keys.lastReadAt = n.lastReadAt;
+    keys.updated = parseTimestamp(n.updatedAt);
+    keys.lastRead = parseTimestamp(n.lastReadAt);
+    keys.text.clear();
+    keys.text.reserve(kTextFieldCount);
+    keys.text.push_back(m_collator.sortKey(n.repository));
+    keys.text.push_back(m_collator.sortKey(n.title));
+    keys.text.push_back(m_collator.sortKey(n.type));
+    keys.text.push_back(m_collator.sortKey(n.reason));
+    return keys;
+}
+
+int NotificationSorter::compare(const Keys& a, const Keys& b) const {
+    for (const SortKey& key : m_criteria) {
+        int cmp = 0;
+        switch (key.field) {
+            case Updated:
+                cmp = compareNumbers(a.updated, b.updated);
+                break;
+            case LastRead:
+                // Never-read items parse to the minimum, so they sort first ascending and last descending
+                cmp = compareNumbers(a.lastRead, b.lastRead);
+                break;
+            default:
+                cmp = a.text[key.field].compare(b.text[key.field]);
+                break;
+        }
+        if (cmp != 0) {
+            return key.order == Qt::AscendingOrder ? cmp : -cmp;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+#ifndef NOTIFICATIONSORTER_H
+#define NOTIFICATIONSORTER_H
+
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <vector>
+
+#include "Notification.h"
+
+// Orders notifications by a list of sort keys (e.g. repository, then reason, then newest update).
+//
+// Collation keys and parsed timestamps are computed once per notification and cached by id, so a re-sort only
+// compares precomputed keys. The sort is stable: items that tie on every key keep their API order.
+class NotificationSorter {
+   public:
+    enum Field { Repository = 0, Title, Type, Reason, Updated, LastRead };
+
+    struct SortKey {
+        Field field;
+        Qt::SortOrder order;
+    };
+
+    NotificationSorter();
+
+    void setCriteria(const QList<SortKey>& criteria) { m_criteria = criteria; }
+    const QList<SortKey>& criteria() const { return m_criteria; }
+
+    void sort(QList<Notification>& notifications);
+    void clearCache() { m_cache.clear(); }
+
+    // Keys are written as a comma separated list of field names, prefixed with '-' for descending order,
+    // e.g. "repository,reason,-updated". Unknown names are skipped.
+    static QList<SortKey> parseCriteria(const QString& spec);
+    static QString criteriaToString(const QList<SortKey>& criteria);
+
+   private:
+    struct Keys {
+        QString repository;
+        QString title;
+        QString type;
+        QString reason;
+        QString updatedAt;
+        QString lastReadAt;
+        qint64 updated = 0;
+        qint64 lastRead = 0;
+        std::vector<QCollatorSortKey> text;
+    };
+
+    const Keys& keysFor(const Notification& n);
+    int compare(const Keys& a, const Keys& b) const;
+
+    QCollator m_collator;
+    QList<SortKey> m_criteria;
+    QHash<QString, Keys> m_cache;
+};
+
+#endif  // NOTIFICATIONSORTER_H
@@ -0,0 +1,164 @@
+#include "NotificationStore.h"
+
+NotificationStore::NotificationStore(QObject* parent)
+    : QObject(parent), m_unreadCount(0), m_repositoriesChanged(false) {}
+
+void NotificationStore::setNotifications(const QList<Notification>& notifications) {
+    int oldTotal = totalCount();
+    int oldUnread = m_unreadCount;
+
+    m_notifications.clear();
+    m_indexById.clear();
+    m_totalByRepo.clear();
+    m_unreadByRepo.clear();
+    m_unreadByReason.clear();
+    m_unreadCount = 0;
+
+    for (const Notification& n : notifications) {
+        upsert(n);
+    }
+
+    // A full refresh can swap repositories and reasons without changing the totals
+    m_repositoriesChanged = true;
+    emitIfChanged(oldTotal, oldUnread);
+    if (oldTotal == totalCount() && oldUnread == m_unreadCount) {
+        emit countsChanged(totalCount(), m_unreadCount);
+    }
+}
+
+void NotificationStore::appendNotifications(const QList<Notification>& notifications) {
+    int oldTotal = totalCount();
+    int oldUnread = m_unreadCount;
+
+    for (const Notification& n : notifications) {
+        upsert(n);
+    }
+
+    emitIfChanged(oldTotal, oldUnread);
+}
+
+void NotificationStore::updateNotification(const Notification& notification) {
+    if (!m_indexById.contains(notification.id)) return;
+
+    int oldTotal = totalCount();
+    int oldUnread = m_unreadCount;
+
+    upsert(notification);
+
+    emitIfChanged(oldTotal, oldUnread);
+}
+
+void NotificationStore::setUnread(const QString& id, bool unread) {
+    auto it = m_indexById.constFind(id);
+    if (it == m_indexById.constEnd()) return;
+
+    Notification& n = m_notifications[it.value()];
+    if (n.unread == unread) return;
+
+    int oldUnread = m_unreadCount;
+    account(n, -1);
+    n.unread = unread;
+    account(n, 1);
+
+    emitIfChanged(totalCount(), oldUnread);
+}
+
+void NotificationStore::removeNotification(const QString& id) {
+    auto it = m_indexById.constFind(id);
+    if (it == m_indexById.constEnd()) return;
+
+    int oldTotal = totalCount();
+    int oldUnread = m_unreadCount;
+
+    int position = it.value();
+    account(m_notifications[position], -1);
+    m_notifications.removeAt(position);
+    m_indexById.remove(id);
+    reindexFrom(position);
+
+    emitIfChanged(oldTotal, oldUnread);
+}
+
+void NotificationStore::clear() { setNotifications(QList<Notification>()); }
+
+const Notification* NotificationStore::find(const QString& id) const {
+    auto it = m_indexById.constFind(id);
+    if (it == m_indexById.constEnd()) return nullptr;
+    return &m_notifications[it.value()];
+}
+
+QStringList NotificationStore::repositories() const {
+    QStringList repos;
+    repos.reserve(m_totalByRepo.size());
+    for (auto it = m_totalByRepo.constBegin(); it != m_totalByRepo.constEnd(); ++it) {
+        if (!it.key().isEmpty()) repos.append(it.key());
+    }
+    repos.sort();
+    return repos;
+}
+
+QList<Notification> NotificationStore::unreadNotifications(int limit) const {
+    QList<Notification> unread;
+    if (limit <= 0 || m_unreadCount == 0) return unread;
+
+    for (const Notification& n : m_notifications) {
+        if (!n.unread) continue;
+        unread.append(n);
+        if (unread.size() >= limit || unread.size() >= m_unreadCount) break;
+    }
+    return unread;
+}
+
+void NotificationStore::account(const Notification& n, int delta) {
+    auto adjust = [delta](QHash<QString, int>& counts, const QString& key) {
+        int value = counts.value(key) + delta;
+        if (value > 0) {
+            counts.insert(key, value);
+        } else {
+            counts.remove(key);
+        }
+    };
+
+    int repoCount = m_totalByRepo.size();
+    adjust(m_totalByRepo, n.repository);
+    if (repoCount != m_totalByRepo.size()) {
+        m_repositoriesChanged = true;
+    }
+
+    if (n.unread) {
+        m_unreadCount += delta;
+        adjust(m_unreadByRepo, n.repository);
+        adjust(m_unreadByReason, n.reason);
+    }
+}
+
+void NotificationStore::upsert(const Notification& n) {
+    auto it = m_indexById.constFind(n.id);
+    if (it != m_indexById.constEnd()) {
+        Notification& existing = m_notifications[it.value()];
+        account(existing, -1);
+        existing = n;
+        account(existing, 1);
+        return;
+    }
+
+    m_indexById.insert(n.id, m_notifications.size());
+    m_notifications.append(n);
+    account(n, 1);
+}
+
+void NotificationStore::reindexFrom(int position) {
+    for (int i = position; i < m_notifications.size(); ++i) {
+        m_indexById.insert(m_notifications[i].id, i);
+    }
+}
+
+void NotificationStore::emitIfChanged(int oldTotal, int oldUnread) {
+    if (m_repositoriesChanged) {
+        m_repositoriesChanged = false;
+        emit repositoriesChanged();
+    }
+    if (oldTotal != totalCount() || oldUnread != m_unreadCount) {
+        emit countsChanged(totalCount(), m_unreadCount);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef NOTIFICATIONSTORE_H
+#define NOTIFICATIONSTORE_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "Notification.h"
+
+// Owns the loaded notifications in API order and keeps the total/unread counters (overall, per repository and
+// per reason) up to date as items are inserted, updated or removed, so readers never have to rescan the list.
+class NotificationStore : public QObject {
+    Q_OBJECT
+   public:
+    explicit NotificationStore(QObject* parent = nullptr);
+
+    void setNotifications(const QList<Notification>& notifications);
+    void appendNotifications(const QList<Notification>& notifications);
+    void updateNotification(const Notification& notification);
+    void setUnread(const QString& id, bool unread);
+    void removeNotification(const QString& id);
+    void clear();
+
+    const QList<Notification>& notifications() const { return m_notifications; }
+    const Notification* find(const QString& id) const;
+    bool contains(const QString& id) const { return m_indexById.contains(id); }
+
+    int totalCount() const { return m_notifications.size(); }
+    int unreadCount() const { return m_unreadCount; }
+    int unreadCountForRepo(const QString& repo) const { return m_unreadByRepo.value(repo); }
+    int unreadCountForReason(const QString& reason) const { return m_unreadByReason.value(reason); }
+    QStringList repositories() const;
+    QList<Notification> unreadNotifications(int limit) const;
+
+   signals:
+    void countsChanged(int total, int unread);
+    void repositoriesChanged();
+
+   private:
+    void account(const Notification& n, int delta);
+    void upsert(const Notification& n);
+    void reindexFrom(int position);
+    void emitIfChanged(int oldTotal, int oldUnread);
+
+    QList<Notification> m_notifications;
+    QHash<QString, int> m_indexById;
+    QHash<QString, int> m_totalByRepo;
+    QHash<QString, int> m_unreadByRepo;
+    QHash<QString, int> m_unreadByReason;
+    int m_unreadCount;
+    bool m_repositoriesChanged;
+};
+
+#endif  // NOTIFICATIONSTORE_H
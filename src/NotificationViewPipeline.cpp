@@ -0,0 +1,156 @@
+#include "NotificationViewPipeline.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QRunnable>
+#include <QThreadPool>
+#include <algorithm>
+
+NotificationViewPipeline::NotificationViewPipeline(QObject* parent)
+    : QObject(parent), m_pool(new QThreadPool(this)), m_latest(0), m_delivered(0) {
+    // One thread keeps results in request order and lets the sorter's key cache go unlocked
+    m_pool->setMaxThreadCount(1);
+}
+
+NotificationViewPipeline::~NotificationViewPipeline() {
+    m_pool->clear();
+    m_pool->waitForDone();
+}
+
+quint64 NotificationViewPipeline::request(const QList<Notification>& snapshot, const NotificationViewParams& params) {
+    quint64 generation = m_latest.loadRelaxed() + 1;
+    m_latest.storeRelease(generation);
+
+    m_pool->start(QRunnable::create([this, snapshot, params, generation]() {
+        if (generation != m_latest.loadAcquire()) return;
+
+        NotificationView view = compute(snapshot, params, m_sorter);
+        view.generation = generation;
+        QMetaObject::invokeMethod(this, [this, view]() { deliver(view); }, Qt::QueuedConnection);
+    }));
+    return generation;
+}
+
+bool NotificationViewPipeline::matchesFilterMode(const Notification& n, int mode) {
+    switch (mode) {
+        case 0:  // All Unread
+            return n.unread;
+        case 1:    // All Read before Updated
+        case 2: {  // Updated recently
+            bool hasBeenRead = !n.lastReadAt.isEmpty();
+            if (!hasBeenRead) return false;
+            QDateTime updated = QDateTime::fromString(n.updatedAt, Qt::ISODate);
+            QDateTime lastRead = QDateTime::fromString(n.lastReadAt, Qt::ISODate);
+            bool updatedRecently = updated > lastRead;
+            return mode == 1 ? !updatedRecently : updatedRecently;
+        }
+        case 3:  // All read
+            return !n.unread;
+        case 4:  // All
+            return true;
+        case 5:  // Mentions (Unread)
+            return n.unread && n.reason == "mention";
+        case 6:  // Mentions (All)
+            return n.reason == "mention";
+        case 7:  // CI Activity (Unread)
+            return n.unread && n.reason == "ci_activity";
+        case 8:  // CI Activity (All)
+            return n.reason == "ci_activity";
+        case 9:  // Review Requested (Unread)
+            return n.unread && n.reason == "review_requested";
+        case 10:  // Review Requested (All)
+            return n.reason == "review_requested";
+        case 11:  // Subscribed (Unread)
+            return n.unread && n.reason == "subscribed";
+        case 12:  // Subscribed (All)
+            return n.reason == "subscribed";
+        default:
+            return false;
+    }
+}
+
+NotificationView NotificationViewPipeline::compute(const QList<Notification>& snapshot,
+                                                   const NotificationViewParams& params, NotificationSorter& sorter) {
+    QList<Notification> target;
+    for (const Notification& n : snapshot) {
+        if (matchesFilterMode(n, params.filterMode)) {
+            target.append(n);
+        }
+    }
+
+    sorter.setCriteria(params.sortKeys);
+    sorter.sort(target);
+
+    NotificationView view;
+    auto isVisible = [&params](const Notification& n) {
+        if (!params.repoFilter.isEmpty() && n.repository != params.repoFilter) return false;
+        if (params.searchFilter.isEmpty()) return true;
+        return n.title.contains(params.searchFilter, Qt::CaseInsensitive) ||
+               n.repository.contains(params.searchFilter, Qt::CaseInsensitive);
+    };
+
+    if (params.groupMode == GroupNone) {
+        view.ids.reserve(target.size());
+        for (const Notification& n : target) {
+            view.ids.append(n.id);
+            if (!isVisible(n)) view.hidden.insert(n.id);
+        }
+        return view;
+    }
+
+    // Members keep their sorted order within a group; collapsed groups only contribute counts
+    QHash<QString, int> groupIndex;
+    for (const Notification& n : target) {
+        QString key = groupKey(n, params.groupMode);
+        auto it = groupIndex.constFind(key);
+        if (it == groupIndex.constEnd()) {
+            NotificationGroup group;
+            group.key = key;
+            group.expanded = params.expandedGroups.contains(key);
+            it = groupIndex.insert(key, view.groups.size());
+            view.groups.append(group);
+        }
+
+        NotificationGroup& group = view.groups[it.value()];
+        group.total++;
+        if (n.unread) group.unread++;
+        bool visible = isVisible(n);
+        if (visible) group.visible++;
+        if (group.expanded) {
+            group.ids.append(n.id);
+            if (!visible) view.hidden.insert(n.id);
+        }
+    }
+
+    // Alphabetical like the repository filter, with the catch-all group for missing values last
+    std::sort(view.groups.begin(), view.groups.end(), [](const NotificationGroup& a, const NotificationGroup& b) {
+        if (a.key.isEmpty() != b.key.isEmpty()) return b.key.isEmpty();
+        return a.key.compare(b.key, Qt::CaseInsensitive) < 0;
+    });
+
+    for (const NotificationGroup& group : view.groups) {
+        view.ids.append(group.ids);
+    }
+    return view;
+}
+
+QString NotificationViewPipeline::groupKey(const Notification& n, int groupMode) {
+    switch (groupMode) {
+        case GroupByRepository:
+            return n.repository;
+        case GroupByReason:
+            return n.reason;
+        case GroupByType:
+            return n.type;
+        default:
+            return QString();
+    }
+}
+
+void NotificationViewPipeline::deliver(const NotificationView& view) {
+    // Anything older than the latest request describes a model the list has already moved past
+    if (view.generation != m_latest.loadRelaxed()) return;
+
+    m_delivered = view.generation;
+    emit viewReady(view);
+}
@@ -0,0 +1,78 @@
+#ifndef NOTIFICATIONVIEWPIPELINE_H
+#define NOTIFICATIONVIEWPIPELINE_H
+
+#include <QAtomicInteger>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "Notification.h"
+#include "NotificationSorter.h"
+
+class QThreadPool;
+
+enum NotificationGroupMode { GroupNone = 0, GroupByRepository, GroupByReason, GroupByType };
+
+struct NotificationViewParams {
+    int filterMode = 0;
+    int groupMode = GroupNone;
+    QSet<QString> expandedGroups;
+    QList<NotificationSorter::SortKey> sortKeys;
+    QString repoFilter;  // Empty shows every repository
+    QString searchFilter;
+};
+
+struct NotificationGroup {
+    QString key;
+    QStringList ids;  // Only filled in for expanded groups
+    int total = 0;
+    int unread = 0;
+    int visible = 0;  // Members left after the repository/search filters
+    bool expanded = false;
+};
+
+// Ordered ids for the list plus the ones the repository/search filters hide. In a grouped view the ids are
+// those of the expanded groups, in group order.
+struct NotificationView {
+    quint64 generation = 0;
+    QStringList ids;
+    QSet<QString> hidden;
+    QList<NotificationGroup> groups;
+};
+
+Q_DECLARE_METATYPE(NotificationView)
+
+// Filters and sorts a snapshot of the notifications on a single worker thread.
+//
+// Every request gets a new generation number; a result is only delivered if no newer request was made in the
+// meantime, and requests that are superseded before they start are skipped entirely.
+class NotificationViewPipeline : public QObject {
+    Q_OBJECT
+   public:
+    explicit NotificationViewPipeline(QObject* parent = nullptr);
+    ~NotificationViewPipeline() override;
+
+    quint64 request(const QList<Notification>& snapshot, const NotificationViewParams& params);
+    bool isPending() const { return m_delivered != m_latest.loadRelaxed(); }
+
+    static bool matchesFilterMode(const Notification& n, int mode);
+    static QString groupKey(const Notification& n, int groupMode);
+    static NotificationView compute(const QList<Notification>& snapshot, const NotificationViewParams& params,
+                                    NotificationSorter& sorter);
+
+   signals:
+    void viewReady(const NotificationView& view);
+
+   private:
+    void deliver(const NotificationView& view);
+
+    QThreadPool* m_pool;
+    NotificationSorter m_sorter;  // Only used from the pool's single thread
+    QAtomicInteger<quint64> m_latest;
+    quint64 m_delivered;
+};
+
+#endif  // NOTIFICATIONVIEWPIPELINE_H
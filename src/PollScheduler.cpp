@@ -0,0 +1,153 @@
+#include "PollScheduler.h"
+
+#include <QDebug>
+#include <limits>
+
+namespace {
+const int kMaxIdleLevel = 2;   // 4x the base interval
+const int kMaxErrorLevel = 6;  // 64x, but see kMaxBackoffMs
+const qint64 kMaxBackoffMs = 60 * 60 * 1000;
+const qint64 kBoostWindowMs = 5 * 60 * 1000;
+const qint64 kMinBoostedMs = 30 * 1000;
+const int kRateLimitShare = 4;  // Polling may use a quarter of what is left; the rest is for details and actions
+
+int clampToInt(qint64 value) { return int(qBound<qint64>(0, value, std::numeric_limits<int>::max())); }
+}  // namespace
+
+PollScheduler::PollScheduler(QObject* parent)
+    : QObject(parent),
+      m_timer(new QTimer(this)),
+      m_lastPollMs(0),
+      m_boostUntilMs(-1),
+      m_baseMs(5 * 60 * 1000),
+      m_serverMinMs(0),
+      m_rateFloorMs(0),
+      m_unchangedStreak(0),
+      m_errorLevel(0),
+      m_pauseReasons(0),
+      m_running(false) {
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &PollScheduler::onTimeout);
+    m_clock.start();
+}
+
+void PollScheduler::setBaseInterval(int ms) {
+    m_baseMs = qMax(1000, ms);
+    schedule();
+}
+
+void PollScheduler::setServerMinimum(int secs) {
+    int minMs = clampToInt(qint64(qMax(0, secs)) * 1000);
+    if (minMs == m_serverMinMs) return;
+    m_serverMinMs = minMs;
+    schedule();
+}
+
+void PollScheduler::setRateLimit(int remaining, qint64 resetEpochSecs) {
+    int floor = 0;
+    if (remaining >= 0 && resetEpochSecs > 0) {
+        qint64 windowMs = qMax<qint64>(0, resetEpochSecs - QDateTime::currentSecsSinceEpoch()) * 1000;
+        floor = clampToInt(windowMs / qMax(1, remaining / kRateLimitShare));
+    }
+    if (floor == m_rateFloorMs) return;
+    if (floor > m_baseMs) {
+        qDebug() << "Rate limit budget low (" << remaining << "left), polling at most every" << floor / 1000 << "s";
+    }
+    m_rateFloorMs = floor;
+    schedule();
+}
+
+void PollScheduler::start() {
+    m_running = true;
+    m_lastPollMs = m_clock.elapsed();
+    schedule();
+}
+
+void PollScheduler::stop() {
+    m_running = false;
+    schedule();
+}
+
+void PollScheduler::notePoll() {
+    m_lastPollMs = m_clock.elapsed();
+    schedule();
+}
+
+void PollScheduler::reportResult(Outcome outcome) {
+    switch (outcome) {
+        case Changed:
+            m_unchangedStreak = 0;
+            m_errorLevel = 0;
+            m_boostUntilMs = m_clock.elapsed() + kBoostWindowMs;
+            break;
+        case Unchanged:
+            m_unchangedStreak++;
+            m_errorLevel = 0;
+            break;
+        case Failed:
+            m_errorLevel = qMin(m_errorLevel + 1, kMaxErrorLevel);
+            break;
+    }
+    schedule();
+}
+
+void PollScheduler::noteActivity() {
+    m_unchangedStreak = 0;
+    m_boostUntilMs = m_clock.elapsed() + kBoostWindowMs;
+    schedule();
+}
+
+void PollScheduler::setPaused(PauseReason reason, bool paused) {
+    int reasons = paused ? (m_pauseReasons | reason) : (m_pauseReasons & ~reason);
+    if (reasons == m_pauseReasons) return;
+
+    bool resumed = m_pauseReasons != 0 && reasons == 0;
+    m_pauseReasons = reasons;
+    if (resumed) {
+        // Whatever happened while away is fetched right away, subject only to the floors: backdate the last poll
+        // so the next one falls due then
+        qint64 earliest = m_lastPollMs + floorMs() - m_clock.elapsed();
+        m_lastPollMs = m_clock.elapsed() + qMax<qint64>(0, earliest) - intervalMs();
+    }
+    schedule();
+}
+
+bool PollScheduler::isBoosted() const { return m_boostUntilMs >= 0 && m_clock.elapsed() < m_boostUntilMs; }
+
+int PollScheduler::floorMs() const { return qMax(m_serverMinMs, m_rateFloorMs); }
+
+int PollScheduler::intervalMs() const {
+    qint64 interval = m_baseMs;
+    if (m_errorLevel > 0) {
+        interval = qMin(qint64(m_baseMs) << m_errorLevel, qMax<qint64>(m_baseMs, kMaxBackoffMs));
+    } else if (isBoosted()) {
+        interval = qMax(kMinBoostedMs, qint64(m_baseMs) / 2);
+    } else if (m_unchangedStreak > 1) {
+        // One quiet poll says little; back off from the second on
+        interval = qint64(m_baseMs) << qMin(m_unchangedStreak - 1, kMaxIdleLevel);
+    }
+    return clampToInt(qMax<qint64>(interval, floorMs()));
+}
+
+qint64 PollScheduler::remainingMs() const { return m_timer->isActive() ? m_timer->remainingTime() : -1; }
+
+QDateTime PollScheduler::nextPollTime() const {
+    qint64 remaining = remainingMs();
+    return remaining < 0 ? QDateTime() : QDateTime::currentDateTime().addMSecs(remaining);
+}
+
+void PollScheduler::onTimeout() {
+    m_lastPollMs = m_clock.elapsed();
+    emit pollRequested();
+    schedule();
+}
+
+void PollScheduler::schedule() {
+    if (!m_running || isPaused()) {
+        m_timer->stop();
+    } else {
+        qint64 wait = m_lastPollMs + intervalMs() - m_clock.elapsed();
+        m_timer->start(clampToInt(wait));
+    }
+    emit scheduleChanged();
+}
@@ -0,0 +1,68 @@
+#ifndef POLLSCHEDULER_H
+#define POLLSCHEDULER_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+// Decides when the next notifications poll happens.
+//
+// The user's refresh interval is the base. It doubles while polls keep coming back unchanged (up to 4x) and while
+// they keep failing (up to an hour), and is halved for a few minutes after new activity or user interaction. The
+// server's X-Poll-Interval and a fair share of the remaining rate-limit budget are floors that always win. While
+// any pause reason is set no polls are made; when the last one clears a poll is made as soon as the floors allow.
+class PollScheduler : public QObject {
+    Q_OBJECT
+   public:
+    enum PauseReason { Offline = 0x1, SessionLocked = 0x2 };
+    enum Outcome { Changed, Unchanged, Failed };
+
+    explicit PollScheduler(QObject* parent = nullptr);
+
+    void setBaseInterval(int ms);
+    void setServerMinimum(int secs);
+    void setRateLimit(int remaining, qint64 resetEpochSecs);
+
+    void start();
+    void stop();
+    // Records a poll made outside the scheduler (manual refresh, settings change) and restarts the wait from now
+    void notePoll();
+    void reportResult(Outcome outcome);
+    void noteActivity();
+    void setPaused(PauseReason reason, bool paused);
+
+    bool isRunning() const { return m_running; }
+    int pauseReasons() const { return m_pauseReasons; }
+    bool isPaused() const { return m_pauseReasons != 0; }
+    bool isBoosted() const;
+    int intervalMs() const;
+    int floorMs() const;
+    // -1 and an invalid time while stopped or paused
+    qint64 remainingMs() const;
+    QDateTime nextPollTime() const;
+
+   signals:
+    void pollRequested();
+    void scheduleChanged();
+
+   private slots:
+    void onTimeout();
+
+   private:
+    void schedule();
+
+    QTimer* m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastPollMs;
+    qint64 m_boostUntilMs;
+    int m_baseMs;
+    int m_serverMinMs;
+    int m_rateFloorMs;
+    int m_unchangedStreak;
+    int m_errorLevel;
+    int m_pauseReasons;
+    bool m_running;
+};
+
+#endif  // POLLSCHEDULER_H
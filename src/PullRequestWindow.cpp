@@ -14,14 +14,17 @@
 #include <QTextEdit>
 #include <QUrl>
 
+#include "AvatarStore.h"
+
 class CommentWidget : public QWidget {
     Q_OBJECT
    public:
-    explicit CommentWidget(const QString& author, const QString& body, const QString& formattedDate,
-                           QWidget* parent = nullptr);
+    explicit CommentWidget(const QString& author, const QString& avatarUrl, const QString& body,
+                           const QString& formattedDate, QWidget* parent = nullptr);
 };
 
-CommentWidget::CommentWidget(const QString& author, const QString& body, const QString& formattedDate, QWidget* parent)
+CommentWidget::CommentWidget(const QString& author, const QString& avatarUrl, const QString& body,
+                             const QString& formattedDate, QWidget* parent)
     : QWidget(parent) {
     QVBoxLayout* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
@@ -34,12 +37,30 @@ CommentWidget::CommentWidget(const QString& author, const QString& body, const Q
     QPushButton* toggleBtn = new QPushButton(QStringLiteral("-"), headerWidget);
     toggleBtn->setFixedSize(20, 20);
 
+    QLabel* avatarLabel = new QLabel(headerWidget);
+    avatarLabel->setFixedSize(24, 24);
+    auto setAvatar = [avatarLabel](const QPixmap& pixmap) {
+        avatarLabel->setPixmap(pixmap.scaled(24, 24, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    };
+    QPixmap avatar = AvatarStore::instance()->avatar(avatarUrl);
+    if (!avatar.isNull()) {
+        setAvatar(avatar);
+    } else if (!avatarUrl.isEmpty()) {
+        // The same participants comment over and over, so most of these are already in the shared store
+        connect(AvatarStore::instance(), &AvatarStore::avatarReady, avatarLabel,
+                [avatarUrl, setAvatar](const QString& url, const QPixmap& pixmap) {
+                    if (url == avatarUrl) setAvatar(pixmap);
+                });
+        AvatarStore::instance()->request(avatarUrl);
+    }
+
     QLabel* headerLabel = new QLabel(tr("**%1** on %2").arg(author, formattedDate), headerWidget);
     headerLabel->setTextFormat(Qt::MarkdownText);
 
     QPushButton* detachBtn = new QPushButton(tr("Detach"), headerWidget);
 
     headerLayout->addWidget(toggleBtn);
+    headerLayout->addWidget(avatarLabel);
     headerLayout->addWidget(headerLabel);
     headerLayout->addStretch();
     headerLayout->addWidget(detachBtn);
@@ -254,10 +275,12 @@ void PullRequestWindow::onPrDetailsReply(QNetworkReply* reply) {
         m_timelineUrl = issueUrl + "/timeline";
 
         // Add the PR body as the first comment
-        QString author = obj["user"].toObject()["login"].toString();
+        QJsonObject user = obj["user"].toObject();
+        QString author = user["login"].toString();
+        QString avatarUrl = user["avatar_url"].toString();
         QString body = obj["body"].toString();
         QString createdAt = obj["created_at"].toString();
-        addCommentToUI(author, body, createdAt);
+        addCommentToUI(author, avatarUrl, body, createdAt);
 
         // Update RHS conversation metadata
         m_openedByLabel->setText(tr("<b>Opened by:</b> %1").arg(author));
@@ -329,10 +352,12 @@ void PullRequestWindow::onTimelineReply(QNetworkReply* reply) {
             QString event = obj["event"].toString();
 
             if (event == "commented") {
-                QString author = obj["user"].toObject()["login"].toString();
+                QJsonObject user = obj["user"].toObject();
+                QString author = user["login"].toString();
+                QString avatarUrl = user["avatar_url"].toString();
                 QString body = obj["body"].toString();
                 QString createdAt = obj["created_at"].toString();
-                addCommentToUI(author, body, createdAt);
+                addCommentToUI(author, avatarUrl, body, createdAt);
             } else {
                 QString createdAt = obj["created_at"].toString();
                 QString text;
@@ -445,14 +470,16 @@ void PullRequestWindow::onReviewCommentsReply(QNetworkReply* reply) {
 
         for (const QJsonValue& val : array) {
             QJsonObject obj = val.toObject();
-            QString author = obj["user"].toObject()["login"].toString();
+            QJsonObject user = obj["user"].toObject();
+            QString author = user["login"].toString();
+            QString avatarUrl = user["avatar_url"].toString();
             QString body = obj["body"].toString();
             QString createdAt = obj["created_at"].toString();
             QString path = obj["path"].toString();
             QString diffHunk = obj["diff_hunk"].toString();
 
             QString fullBody = tr("**Review comment on %1:**\n\n```diff\n%2\n```\n\n%3").arg(path, diffHunk, body);
-            addCommentToUI(author, fullBody, createdAt);
+            addCommentToUI(author, avatarUrl, fullBody, createdAt);
         }
     }
     reply->deleteLater();
@@ -550,11 +577,12 @@ void PullRequestWindow::onFileDoubleClicked(int row, int column) {
     }
 }
 
-void PullRequestWindow::addCommentToUI(const QString& author, const QString& body, const QString& createdAt) {
+void PullRequestWindow::addCommentToUI(const QString& author, const QString& avatarUrl, const QString& body,
+                                       const QString& createdAt) {
     QDateTime dt = QDateTime::fromString(createdAt, Qt::ISODate);
     QString formattedDate = dt.isValid() ? QLocale().toString(dt.toLocalTime(), QLocale::ShortFormat) : createdAt;
 
-    CommentWidget* widget = new CommentWidget(author, body, formattedDate);
+    CommentWidget* widget = new CommentWidget(author, avatarUrl, body, formattedDate);
     m_commentsContainerLayout->addWidget(widget);
 }
 
@@ -624,10 +652,12 @@ void PullRequestWindow::onPostCommentReply(QNetworkReply* reply) {
         QByteArray data = reply->readAll();
         QJsonDocument doc = QJsonDocument::fromJson(data);
         QJsonObject obj = doc.object();
-        QString author = obj["user"].toObject()["login"].toString();
+        QJsonObject user = obj["user"].toObject();
+        QString author = user["login"].toString();
+        QString avatarUrl = user["avatar_url"].toString();
         QString body = obj["body"].toString();
         QString createdAt = obj["created_at"].toString();
-        addCommentToUI(author, body, createdAt);
+        addCommentToUI(author, avatarUrl, body, createdAt);
     } else {
         QMessageBox::warning(this, tr("Error"), tr("Failed to post comment: %1").arg(reply->errorString()));
     }
@@ -93,7 +93,8 @@ class PullRequestWindow : public KXmlGuiWindow {
     QString m_timelineUrl;
 
     void setupUi();
-    void addCommentToUI(const QString& author, const QString& body, const QString& createdAt);
+    void addCommentToUI(const QString& author, const QString& avatarUrl, const QString& body,
+                        const QString& createdAt);
     void setupMenus();
     QString m_rawJsonStr;
 };
@@ -1,28 +1,81 @@
 #include "RulesDialog.h"
 
+#include <QCheckBox>
 #include <QComboBox>
+#include <QDateTime>
 #include <QDialogButtonBox>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QLabel>
 #include <QLineEdit>
+#include <QLocale>
 #include <QMessageBox>
+#include <QTabWidget>
 #include <QVBoxLayout>
 
 #include "NotificationRuleEngine.h"
 
+namespace {
+// Extra options that only apply to "Mute", shared by the add and edit dialogs
+struct MuteOptionWidgets {
+    QCheckBox* hide;
+    QComboBox* serverAction;
+    QCheckBox* unsubscribe;
+};
+
+MuteOptionWidgets addMuteOptions(QDialog* dialog, QVBoxLayout* layout, QComboBox* actionCombo,
+                                 const NotificationRule& rule) {
+    MuteOptionWidgets widgets;
+    widgets.hide = new QCheckBox(QObject::tr("Hide from the list (no details are fetched)"), dialog);
+    widgets.hide->setChecked(rule.hideFromList);
+    layout->addWidget(widgets.hide);
+
+    widgets.serverAction = new QComboBox(dialog);
+    widgets.serverAction->addItem(QObject::tr("Leave on GitHub"), QString());
+    widgets.serverAction->addItem(QObject::tr("Mark as read on GitHub"), QStringLiteral("MarkRead"));
+    widgets.serverAction->addItem(QObject::tr("Mark as done on GitHub"), QStringLiteral("MarkDone"));
+    widgets.serverAction->setCurrentIndex(qMax(0, widgets.serverAction->findData(rule.serverAction)));
+    layout->addWidget(widgets.serverAction);
+
+    widgets.unsubscribe = new QCheckBox(QObject::tr("Unsubscribe from the thread"), dialog);
+    widgets.unsubscribe->setChecked(rule.unsubscribe);
+    layout->addWidget(widgets.unsubscribe);
+
+    auto updateEnabled = [widgets, actionCombo]() {
+        bool isMute = actionCombo->currentText() == "Mute";
+        widgets.hide->setEnabled(isMute);
+        widgets.serverAction->setEnabled(isMute);
+        widgets.unsubscribe->setEnabled(isMute);
+    };
+    QObject::connect(actionCombo, &QComboBox::currentTextChanged, dialog, updateEnabled);
+    updateEnabled();
+    return widgets;
+}
+
+void readMuteOptions(const MuteOptionWidgets& widgets, NotificationRule& rule) {
+    bool isMute = rule.action == "Mute";
+    rule.hideFromList = isMute && widgets.hide->isChecked();
+    rule.serverAction = isMute ? widgets.serverAction->currentData().toString() : QString();
+    rule.unsubscribe = isMute && widgets.unsubscribe->isChecked();
+}
+}  // namespace
+
 RulesDialog::RulesDialog(QWidget* parent, const QString& preFilterRepo, const QString& prepopulateCondition)
     : QDialog(parent), m_prepopulateCondition(prepopulateCondition) {
     setWindowTitle(tr("Notification Rules"));
-    resize(600, 400);
+    resize(800, 400);
 
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
 
-    rulesTable = new QTableWidget(0, 2, this);
+    rulesTable = new QTableWidget(0, 6, this);
     rulesTable->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
-    rulesTable->setHorizontalHeaderLabels({tr("Rule Matcher"), tr("Action")});
+    rulesTable->setHorizontalHeaderLabels(
+        {tr("Rule Matcher"), tr("Action"), tr("Checked"), tr("Matched"), tr("Last Match"), tr("Avg Cost")});
     rulesTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    for (int column = 1; column < rulesTable->columnCount(); ++column) {
+        rulesTable->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+    }
     rulesTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     rulesTable->setSelectionMode(QAbstractItemView::SingleSelection);
     mainLayout->addWidget(rulesTable);
@@ -33,6 +86,16 @@ RulesDialog::RulesDialog(QWidget* parent, const QString& preFilterRepo, const QS
     QPushButton* btnUp = new QPushButton(tr("Move Up"), this);
     QPushButton* btnDown = new QPushButton(tr("Move Down"), this);
     QPushButton* btnRemove = new QPushButton(tr("Remove"), this);
+    QPushButton* btnResetStats = new QPushButton(tr("Reset Stats"), this);
+    QPushButton* btnSimulate = new QPushButton(tr("Simulate"), this);
+    btnSimulate->setToolTip(tr("Run the rules as edited, without saving, over the loaded notifications"));
+    if (!preFilterRepo.isEmpty()) {
+        // The table only holds this repository's rules, so a simulation would miss every other rule
+        btnSimulate->setEnabled(false);
+        btnSimulate->setToolTip(tr("Only the rules for %1 are shown. Open Notification Rules from the main window "
+                                   "to simulate the whole rule set.")
+                                    .arg(preFilterRepo));
+    }
     QPushButton* btnSave = new QPushButton(tr("Save"), this);
     QPushButton* btnClose = new QPushButton(tr("Close"), this);
 
@@ -41,6 +104,8 @@ RulesDialog::RulesDialog(QWidget* parent, const QString& preFilterRepo, const QS
     buttonLayout->addWidget(btnRemove);
     buttonLayout->addWidget(btnUp);
     buttonLayout->addWidget(btnDown);
+    buttonLayout->addWidget(btnResetStats);
+    buttonLayout->addWidget(btnSimulate);
 
     buttonLayout->addStretch();
     buttonLayout->addWidget(btnSave);
@@ -53,6 +118,8 @@ RulesDialog::RulesDialog(QWidget* parent, const QString& preFilterRepo, const QS
     connect(btnRemove, &QPushButton::clicked, this, &RulesDialog::removeRule);
     connect(btnUp, &QPushButton::clicked, this, &RulesDialog::moveUp);
     connect(btnDown, &QPushButton::clicked, this, &RulesDialog::moveDown);
+    connect(btnResetStats, &QPushButton::clicked, this, &RulesDialog::resetStats);
+    connect(btnSimulate, &QPushButton::clicked, this, &RulesDialog::simulate);
 
     connect(btnSave, &QPushButton::clicked, this, &RulesDialog::saveRules);
     connect(btnClose, &QPushButton::clicked, this, &QDialog::accept);
@@ -68,9 +135,44 @@ void RulesDialog::loadRules(const QString& filterRepo) {
 
         int row = rulesTable->rowCount();
         rulesTable->insertRow(row);
-        rulesTable->setItem(row, 0, new QTableWidgetItem(rule.displayCondition()));
-        rulesTable->item(row, 0)->setData(Qt::UserRole, QVariant::fromValue(rule.toJson()));
-        rulesTable->setItem(row, 1, new QTableWidgetItem(rule.action));
+        setRuleRow(row, rule);
+    }
+}
+
+void RulesDialog::setRuleRow(int row, const NotificationRule& rule) {
+    QTableWidgetItem* conditionItem = new QTableWidgetItem(rule.displayCondition());
+    conditionItem->setData(Qt::UserRole, QVariant::fromValue(rule.toJson()));
+    rulesTable->setItem(row, 0, conditionItem);
+    rulesTable->setItem(row, 1, new QTableWidgetItem(rule.displayAction()));
+    updateStatsColumns(row, NotificationRuleEngine::statsFor(rule));
+}
+
+void RulesDialog::updateStatsColumns(int row, const RuleStats& stats) {
+    QString lastMatch = tr("Never");
+    if (stats.lastMatchSecs > 0) {
+        lastMatch = QLocale().toString(QDateTime::fromSecsSinceEpoch(stats.lastMatchSecs), QLocale::ShortFormat);
+    }
+    // Rules that are never checked (e.g. "Default") have no cost to show
+    QString cost = stats.evaluations > 0 ? tr("%1 µs").arg(stats.totalNs / 1000.0 / stats.evaluations, 0, 'f', 2)
+                                         : QStringLiteral("-");
+
+    const QStringList values = {QString::number(stats.evaluations), QString::number(stats.matches), lastMatch, cost};
+    for (int i = 0; i < values.size(); ++i) {
+        QTableWidgetItem* item = new QTableWidgetItem(values.at(i));
+        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+        if (i != 2) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        rulesTable->setItem(row, 2 + i, item);
+    }
+}
+
+void RulesDialog::resetStats() {
+    if (QMessageBox::question(this, tr("Reset Stats"), tr("Reset the counters of all rules?")) != QMessageBox::Yes) {
+        return;
+    }
+
+    NotificationRuleEngine::resetStats();
+    for (int row = 0; row < rulesTable->rowCount(); ++row) {
+        updateStatsColumns(row, RuleStats());
     }
 }
 
@@ -104,6 +206,7 @@ void RulesDialog::addRule(const QString& prepopulateRepo) {
     QComboBox actionCombo;
     actionCombo.addItems({"Mute", "AlwaysIndividual", "NeverIndividual", "AlwaysSummarize", "Default"});
     layout.addWidget(&actionCombo);
+    MuteOptionWidgets muteOptions = addMuteOptions(&dialog, &layout, &actionCombo, NotificationRule());
 
     QDialogButtonBox buttonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, &dialog);
     layout.addWidget(&buttonBox);
@@ -117,12 +220,11 @@ void RulesDialog::addRule(const QString& prepopulateRepo) {
         rule.reasonFilter = reasonEdit.text().trimmed();
         rule.titleFilter = titleEdit.text().trimmed();
         rule.action = actionCombo.currentText();
+        readMuteOptions(muteOptions, rule);
 
         int row = rulesTable->rowCount();
         rulesTable->insertRow(row);
-        rulesTable->setItem(row, 0, new QTableWidgetItem(rule.displayCondition()));
-        rulesTable->item(row, 0)->setData(Qt::UserRole, QVariant::fromValue(rule.toJson()));
-        rulesTable->setItem(row, 1, new QTableWidgetItem(rule.action));
+        setRuleRow(row, rule);
     }
 }
 void RulesDialog::editRule() {
@@ -162,6 +264,7 @@ void RulesDialog::editRule() {
     actionCombo.addItems({"Mute", "AlwaysIndividual", "NeverIndividual", "AlwaysSummarize", "Default"});
     actionCombo.setCurrentText(rule.action);
     layout.addWidget(&actionCombo);
+    MuteOptionWidgets muteOptions = addMuteOptions(&dialog, &layout, &actionCombo, rule);
 
     QDialogButtonBox buttonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, &dialog);
     layout.addWidget(&buttonBox);
@@ -174,10 +277,9 @@ void RulesDialog::editRule() {
         rule.reasonFilter = reasonEdit.text().trimmed();
         rule.titleFilter = titleEdit.text().trimmed();
         rule.action = actionCombo.currentText();
+        readMuteOptions(muteOptions, rule);
 
-        rulesTable->item(row, 0)->setText(rule.displayCondition());
-        rulesTable->item(row, 0)->setData(Qt::UserRole, QVariant::fromValue(rule.toJson()));
-        rulesTable->item(row, 1)->setText(rule.action);
+        setRuleRow(row, rule);
     }
 }
 void RulesDialog::removeRule() {
@@ -187,24 +289,108 @@ void RulesDialog::removeRule() {
     }
 }
 
-void RulesDialog::saveRules() {
+QList<NotificationRule> RulesDialog::rulesFromTable() const {
     QList<NotificationRule> rules;
     for (int i = 0; i < rulesTable->rowCount(); ++i) {
         QJsonObject obj = rulesTable->item(i, 0)->data(Qt::UserRole).toJsonObject();
         NotificationRule rule = NotificationRule::fromJson(obj);
         rules.append(rule);
     }
-    NotificationRuleEngine::saveRules(rules);
+    return rules;
+}
+
+void RulesDialog::saveRules() { NotificationRuleEngine::saveRules(rulesFromTable()); }
+
+void RulesDialog::setSimulationNotifications(const QList<Notification>& notifications) {
+    m_simulationNotifications = notifications;
+}
+
+void RulesDialog::simulate() {
+    if (m_simulationNotifications.isEmpty()) {
+        QMessageBox::information(this, tr("Simulate"),
+                                 tr("There are no loaded notifications to simulate against. Open the rules from the "
+                                    "main window once notifications have been fetched."));
+        return;
+    }
+
+    // A private set keeps simulated checks out of the real rule stats
+    const QList<NotificationRule> rules = rulesFromTable();
+    NotificationRuleSet ruleSet(rules);
+
+    RuleSimulation result = ruleSet.simulate(m_simulationNotifications);
+    const QList<int>& decisions = result.decisions;
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Rule Simulation"));
+    dialog.resize(800, 500);
+    QVBoxLayout layout(&dialog);
+
+    QLabel* summaryLabel = new QLabel(
+        tr("%1 notifications: %2 muted, %3 always individual, %4 summarized, %5 left to the summary threshold.\n"
+           "Total evaluation time: %6 ms (%7 µs per notification).")
+            .arg(m_simulationNotifications.size())
+            .arg(result.muted)
+            .arg(result.individual)
+            .arg(result.summarized)
+            .arg(result.unmatched)
+            .arg(result.totalNs / 1000000.0, 0, 'f', 3)
+            .arg(result.totalNs / 1000.0 / m_simulationNotifications.size(), 0, 'f', 2));
+    summaryLabel->setWordWrap(true);
+    layout.addWidget(summaryLabel);
+
+    QTabWidget* tabs = new QTabWidget(&dialog);
+    layout.addWidget(tabs);
+
+    QTableWidget* ruleTable = new QTableWidget(rules.size(), 5, tabs);
+    ruleTable->setHorizontalHeaderLabels({tr("Rule Matcher"), tr("Action"), tr("Checked"), tr("Decided"), tr("Cost")});
+    ruleTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    ruleTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    for (int i = 0; i < rules.size(); ++i) {
+        RuleStats stats = ruleSet.statsAt(i);
+        ruleTable->setItem(i, 0, new QTableWidgetItem(rules.at(i).displayCondition()));
+        ruleTable->setItem(i, 1, new QTableWidgetItem(rules.at(i).displayAction()));
+        ruleTable->setItem(i, 2, new QTableWidgetItem(QString::number(stats.evaluations)));
+        ruleTable->setItem(i, 3, new QTableWidgetItem(QString::number(stats.matches)));
+        ruleTable->setItem(i, 4, new QTableWidgetItem(tr("%1 µs").arg(stats.totalNs / 1000.0, 0, 'f', 1)));
+    }
+    tabs->addTab(ruleTable, tr("By Rule"));
+
+    QTableWidget* notificationTable = new QTableWidget(m_simulationNotifications.size(), 4, tabs);
+    notificationTable->setHorizontalHeaderLabels({tr("Title"), tr("Repository"), tr("Action"), tr("Decided By")});
+    notificationTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    notificationTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    for (int i = 0; i < m_simulationNotifications.size(); ++i) {
+        const Notification& n = m_simulationNotifications.at(i);
+        int ruleIndex = decisions.at(i);
+        QString decidedBy = ruleIndex >= 0
+                                ? tr("#%1 %2").arg(ruleIndex + 1).arg(rules.at(ruleIndex).displayCondition())
+                                : tr("No rule");
+        notificationTable->setItem(i, 0, new QTableWidgetItem(n.title));
+        notificationTable->setItem(i, 1, new QTableWidgetItem(n.repository));
+        notificationTable->setItem(i, 2, new QTableWidgetItem(ruleSet.actionAt(ruleIndex)));
+        notificationTable->setItem(i, 3, new QTableWidgetItem(decidedBy));
+    }
+    tabs->addTab(notificationTable, tr("By Notification"));
+
+    QDialogButtonBox buttonBox(QDialogButtonBox::Close, Qt::Horizontal, &dialog);
+    layout.addWidget(&buttonBox);
+    connect(&buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    dialog.exec();
 }
+
 void RulesDialog::moveUp() {
     int row = rulesTable->currentRow();
     if (row > 0) {
-        QTableWidgetItem* conditionItem = rulesTable->takeItem(row, 0);
-        QTableWidgetItem* actionItem = rulesTable->takeItem(row, 1);
+        QList<QTableWidgetItem*> items;
+        for (int column = 0; column < rulesTable->columnCount(); ++column) {
+            items.append(rulesTable->takeItem(row, column));
+        }
         rulesTable->removeRow(row);
         rulesTable->insertRow(row - 1);
-        rulesTable->setItem(row - 1, 0, conditionItem);
-        rulesTable->setItem(row - 1, 1, actionItem);
+        for (int column = 0; column < items.size(); ++column) {
+            rulesTable->setItem(row - 1, column, items.at(column));
+        }
         rulesTable->selectRow(row - 1);
     }
 }
@@ -212,12 +398,15 @@ void RulesDialog::moveUp() {
 void RulesDialog::moveDown() {
     int row = rulesTable->currentRow();
     if (row >= 0 && row < rulesTable->rowCount() - 1) {
-        QTableWidgetItem* conditionItem = rulesTable->takeItem(row, 0);
-        QTableWidgetItem* actionItem = rulesTable->takeItem(row, 1);
+        QList<QTableWidgetItem*> items;
+        for (int column = 0; column < rulesTable->columnCount(); ++column) {
+            items.append(rulesTable->takeItem(row, column));
+        }
         rulesTable->removeRow(row);
         rulesTable->insertRow(row + 1);
-        rulesTable->setItem(row + 1, 0, conditionItem);
-        rulesTable->setItem(row + 1, 1, actionItem);
+        for (int column = 0; column < items.size(); ++column) {
+            rulesTable->setItem(row + 1, column, items.at(column));
+        }
         rulesTable->selectRow(row + 1);
     }
 }
@@ -5,12 +5,17 @@
 #include <QPushButton>
 #include <QTableWidget>
 
+#include "NotificationRuleEngine.h"
+
 class RulesDialog : public QDialog {
     Q_OBJECT
    public:
     explicit RulesDialog(QWidget* parent = nullptr, const QString& preFilterRepo = QString(),
                          const QString& prepopulateCondition = QString());
 
+    // Notifications the "Simulate" button runs the edited rules over
+    void setSimulationNotifications(const QList<Notification>& notifications);
+
    private slots:
     void addRule(const QString& prepopulateCondition = QString());
 
@@ -20,10 +25,16 @@ class RulesDialog : public QDialog {
     void moveDown();
 
     void saveRules();
+    void resetStats();
+    void simulate();
 
    private:
     void loadRules(const QString& filterRepo = QString());
+    void setRuleRow(int row, const NotificationRule& rule);
+    void updateStatsColumns(int row, const RuleStats& stats);
+    QList<NotificationRule> rulesFromTable() const;
     QString m_prepopulateCondition;
+    QList<Notification> m_simulationNotifications;
 
     QTableWidget* rulesTable;
 };
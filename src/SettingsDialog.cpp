@@ -14,11 +14,13 @@
 #include <QTextStream>
 #include <QVBoxLayout>
 
+#include "AppSettings.h"
 #include "GitHubClient.h"
 #include "RulesDialog.h"
 #include "WalletManager.h"
 
-SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nullptr) {
+SettingsDialog::SettingsDialog(QWidget* parent)
+    : QDialog(parent), testClient(nullptr), m_walletTokenLoaded(false), m_savingToken(false) {
     setWindowTitle("Settings");
 
     QVBoxLayout* layout = new QVBoxLayout(this);
@@ -43,14 +45,22 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nu
     tokenEdit->setEnabled(false);
     tokenEdit->setPlaceholderText("Loading...");
 
-    QFutureWatcher<QString>* watcher = new QFutureWatcher<QString>(this);
-    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher]() {
-        tokenEdit->setText(watcher->result());
+    QFutureWatcher<WalletManager::Result>* watcher = new QFutureWatcher<WalletManager::Result>(this);
+    connect(watcher, &QFutureWatcher<WalletManager::Result>::finished, this, [this, watcher]() {
+        WalletManager::Result result = watcher->result();
+        if (result.ok()) {
+            m_walletToken = result.token;
+            m_walletTokenLoaded = true;
+            tokenEdit->setText(result.token);
+        } else {
+            statusLabel->setText("Could not read the saved token: " + result.errorString());
+            statusLabel->setStyleSheet("color: red;");
+            statusLabel->show();
+        }
         tokenEdit->setEnabled(true);
         tokenEdit->setPlaceholderText("");
         watcher->deleteLater();
     });
-    watcher->setFuture(getTokenAsync());
 
     tokenLayout->addWidget(tokenEdit);
 
@@ -63,6 +73,7 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nu
     statusLabel = new QLabel(this);
     statusLabel->hide();
     layout->addWidget(statusLabel);
+    watcher->setFuture(getTokenAsync());
 
     // Interval
     QLabel* intervalLabel = new QLabel("Refresh Interval (minutes):", this);
@@ -84,12 +95,12 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nu
     layout->addWidget(dataLabel);
 
     dataOptionCombo = new QComboBox(this);
-    dataOptionCombo->addItem("Incrementally Manual", GetDataOption::Manual);
-    dataOptionCombo->addItem("Incrementally Fill Screen (Then Manual)", GetDataOption::FillScreen);
-    dataOptionCombo->addItem("Get All Data", GetDataOption::GetAll);
-    dataOptionCombo->addItem("Infinite Scrolling", GetDataOption::Infinite);
+    dataOptionCombo->addItem("Incrementally Manual", AppSettings::Manual);
+    dataOptionCombo->addItem("Incrementally Fill Screen (Then Manual)", AppSettings::FillScreen);
+    dataOptionCombo->addItem("Get All Data", AppSettings::GetAll);
+    dataOptionCombo->addItem("Infinite Scrolling", AppSettings::Infinite);
 
-    GetDataOption currentOption = getGetDataOption();
+    AppSettings::GetDataOption currentOption = getGetDataOption();
     index = dataOptionCombo->findData(currentOption);
     if (index >= 0) {
         dataOptionCombo->setCurrentIndex(index);
@@ -139,6 +150,35 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nu
     }
     layout->addWidget(trayUnreadLimitCombo);
 
+    QLabel* hydrationPrefetchLabel = new QLabel("Rows to preload details for outside the visible list:", this);
+    layout->addWidget(hydrationPrefetchLabel);
+
+    hydrationPrefetchCombo = new QComboBox(this);
+    hydrationPrefetchCombo->addItems({"0", "5", "10", "20", "50"});
+    int currentPrefetch = getHydrationPrefetchRows();
+    index = hydrationPrefetchCombo->findText(QString::number(currentPrefetch));
+    if (index >= 0) {
+        hydrationPrefetchCombo->setCurrentIndex(index);
+    } else {
+        hydrationPrefetchCombo->setCurrentText("10");
+    }
+    layout->addWidget(hydrationPrefetchCombo);
+
+    // Avatar memory
+    QLabel* avatarCacheLabel = new QLabel("Avatar cache size (MB):", this);
+    layout->addWidget(avatarCacheLabel);
+
+    avatarCacheCombo = new QComboBox(this);
+    avatarCacheCombo->addItems({"4", "8", "16", "32", "64"});
+    int currentAvatarCache = getAvatarCacheMb();
+    index = avatarCacheCombo->findText(QString::number(currentAvatarCache));
+    if (index >= 0) {
+        avatarCacheCombo->setCurrentIndex(index);
+    } else {
+        avatarCacheCombo->setCurrentText("16");
+    }
+    layout->addWidget(avatarCacheCombo);
+
     // Startup
     autostartCheckBox = new QCheckBox("Run on startup", this);
     startMinimizedCheckBox = new QCheckBox("Start minimized (tray only)", this);
@@ -151,6 +191,20 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nu
     notifyOnceCheckBox->setChecked(getNotifyOnce());
     layout->addWidget(notifyOnceCheckBox);
 
+    QLabel* knownRetentionLabel = new QLabel("Forget notified threads after (days):", this);
+    layout->addWidget(knownRetentionLabel);
+
+    knownRetentionCombo = new QComboBox(this);
+    knownRetentionCombo->addItems({"30", "90", "180", "365"});
+    int currentRetention = getKnownNotificationRetentionDays();
+    index = knownRetentionCombo->findText(QString::number(currentRetention));
+    if (index >= 0) {
+        knownRetentionCombo->setCurrentIndex(index);
+    } else {
+        knownRetentionCombo->setCurrentText("180");
+    }
+    layout->addWidget(knownRetentionCombo);
+
     notifyReadCheckBox = new QCheckBox("Notify on read notifications", this);
     notifyReadCheckBox->setChecked(getNotifyRead());
     layout->addWidget(notifyReadCheckBox);
@@ -191,8 +245,8 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nu
     connect(autostartCheckBox, &QCheckBox::toggled, startMinimizedCheckBox, &QCheckBox::setEnabled);
 
     QHBoxLayout* buttonLayout = new QHBoxLayout();
-    QPushButton* saveButton = new QPushButton("Save", this);
-    QPushButton* cancelButton = new QPushButton("Cancel", this);
+    saveButton = new QPushButton("Save", this);
+    cancelButton = new QPushButton("Cancel", this);
 
     buttonLayout->addWidget(saveButton);
     buttonLayout->addWidget(cancelButton);
@@ -203,16 +257,63 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent), testClient(nu
 }
 
 void SettingsDialog::saveSettings() {
-    WalletManager::saveToken(tokenEdit->text());
+    QString token = tokenEdit->text();
+    // Nothing to write if the token is unchanged, or if it never loaded and nothing was entered in its place
+    bool tokenChanged = m_walletTokenLoaded ? token != m_walletToken : !token.isEmpty();
+    if (!tokenChanged) {
+        applySettings();
+        return;
+    }
+
+    // The wallet may have to be unlocked first, so the dialog stays responsive and open until it is written
+    m_savingToken = true;
+    saveButton->setEnabled(false);
+    cancelButton->setEnabled(false);
+    statusLabel->setText("Saving token to the wallet...");
+    statusLabel->setStyleSheet("color: black;");
+    statusLabel->show();
+
+    QFutureWatcher<WalletManager::Result>* watcher = new QFutureWatcher<WalletManager::Result>(this);
+    connect(watcher, &QFutureWatcher<WalletManager::Result>::finished, this, [this, watcher]() {
+        WalletManager::Result result = watcher->result();
+        watcher->deleteLater();
+        m_savingToken = false;
+        saveButton->setEnabled(true);
+        cancelButton->setEnabled(true);
+        if (!result.ok()) {
+            statusLabel->setText("Could not save the token: " + result.errorString());
+            statusLabel->setStyleSheet("color: red;");
+            return;
+        }
+        m_walletToken = result.token;
+        m_walletTokenLoaded = true;
+        applySettings();
+    });
+    watcher->setFuture(WalletManager::saveTokenAsync(token));
+}
 
-    QSettings settings;
-    settings.setValue("interval", intervalCombo->currentText().toInt());
-    settings.setValue("dataOption", dataOptionCombo->currentData().toInt());
-    settings.setValue("summaryThreshold", summaryThresholdCombo->currentText().toInt());
-    settings.setValue("notificationDelayMs", notificationDelayCombo->currentText().toInt());
-    settings.setValue("trayUnreadLimit", trayUnreadLimitCombo->currentText().toInt());
-    setNotifyOnce(notifyOnceCheckBox->isChecked());
-    setNotifyRead(notifyReadCheckBox->isChecked());
+void SettingsDialog::reject() {
+    // Escape or the close button while the token is being written would leave it saved but the settings not
+    if (m_savingToken) return;
+    QDialog::reject();
+}
+
+void SettingsDialog::applySettings() {
+    {
+        QSettings settings;
+        settings.setValue("interval", intervalCombo->currentText().toInt());
+        settings.setValue("dataOption", dataOptionCombo->currentData().toInt());
+        settings.setValue("summaryThreshold", summaryThresholdCombo->currentText().toInt());
+        settings.setValue("notificationDelayMs", notificationDelayCombo->currentText().toInt());
+        settings.setValue("trayUnreadLimit", trayUnreadLimitCombo->currentText().toInt());
+        settings.setValue("hydrationPrefetchRows", hydrationPrefetchCombo->currentText().toInt());
+        settings.setValue("avatarCacheMb", avatarCacheCombo->currentText().toInt());
+        settings.setValue("knownNotificationRetentionDays", knownRetentionCombo->currentText().toInt());
+        settings.setValue("notifyOnce", notifyOnceCheckBox->isChecked());
+        settings.setValue("notifyRead", notifyReadCheckBox->isChecked());
+    }
+    // One reload for the whole dialog; listeners get a signal per value that changed
+    AppSettings::instance()->reload();
 
     updateAutostartEntry();
 
@@ -257,55 +358,40 @@ bool SettingsDialog::isAutostartEnabled() {
     return QFile::exists(path);
 }
 
-QString SettingsDialog::getToken() { return WalletManager::loadToken(); }
+QFuture<WalletManager::Result> SettingsDialog::getTokenAsync() { return WalletManager::loadTokenAsync(); }
 
-QFuture<QString> SettingsDialog::getTokenAsync() { return WalletManager::loadTokenAsync(); }
+int SettingsDialog::getInterval() { return AppSettings::instance()->interval(); }
 
-int SettingsDialog::getInterval() {
-    QSettings settings;
-    return settings.value("interval", 5).toInt();
-}
+AppSettings::GetDataOption SettingsDialog::getGetDataOption() { return AppSettings::instance()->dataOption(); }
 
-SettingsDialog::GetDataOption SettingsDialog::getGetDataOption() {
-    QSettings settings;
-    return static_cast<GetDataOption>(settings.value("dataOption", GetDataOption::Manual).toInt());
-}
+int SettingsDialog::getSummaryThreshold() { return AppSettings::instance()->summaryThreshold(); }
 
-int SettingsDialog::getSummaryThreshold() {
-    QSettings settings;
-    return settings.value("summaryThreshold", 3).toInt();
-}
+int SettingsDialog::getNotificationDelayMs() { return AppSettings::instance()->notificationDelayMs(); }
 
-int SettingsDialog::getNotificationDelayMs() {
-    QSettings settings;
-    return settings.value("notificationDelayMs", 1000).toInt();
-}
+int SettingsDialog::getTrayUnreadLimit() { return AppSettings::instance()->trayUnreadLimit(); }
 
-int SettingsDialog::getTrayUnreadLimit() {
-    QSettings settings;
-    return settings.value("trayUnreadLimit", 5).toInt();
-}
+int SettingsDialog::getHydrationPrefetchRows() { return AppSettings::instance()->hydrationPrefetchRows(); }
 
-bool SettingsDialog::getNotifyOnce() {
-    QSettings settings;
-    return settings.value("notifyOnce", true).toBool();
-}
+int SettingsDialog::getAvatarCacheMb() { return AppSettings::instance()->avatarCacheMb(); }
 
-void SettingsDialog::setNotifyOnce(bool notify) {
-    QSettings settings;
-    settings.setValue("notifyOnce", notify);
+int SettingsDialog::getKnownNotificationRetentionDays() {
+    return AppSettings::instance()->knownNotificationRetentionDays();
 }
 
-bool SettingsDialog::getNotifyRead() {
-    QSettings settings;
-    return settings.value("notifyRead", false).toBool();
-}
+QString SettingsDialog::getCustomSortKeys() { return AppSettings::instance()->customSortKeys(); }
 
-void SettingsDialog::setNotifyRead(bool notify) {
-    QSettings settings;
-    settings.setValue("notifyRead", notify);
+void SettingsDialog::setCustomSortKeys(const QString& spec) {
+    AppSettings::instance()->setValue("customSortKeys", spec);
 }
 
+bool SettingsDialog::getNotifyOnce() { return AppSettings::instance()->notifyOnce(); }
+
+void SettingsDialog::setNotifyOnce(bool notify) { AppSettings::instance()->setValue("notifyOnce", notify); }
+
+bool SettingsDialog::getNotifyRead() { return AppSettings::instance()->notifyRead(); }
+
+void SettingsDialog::setNotifyRead(bool notify) { AppSettings::instance()->setValue("notifyRead", notify); }
+
 void SettingsDialog::onTestClicked() {
     if (tokenEdit->text().isEmpty()) {
         statusLabel->setText("Please enter a token first.");
@@ -5,6 +5,9 @@
 #include <QFuture>
 #include <QLineEdit>
 
+#include "AppSettings.h"
+#include "WalletManager.h"
+
 class QComboBox;
 class QPushButton;
 class QLabel;
@@ -15,21 +18,29 @@ class SettingsDialog : public QDialog {
     Q_OBJECT
    public:
     explicit SettingsDialog(QWidget* parent = nullptr);
-    enum GetDataOption { Manual, FillScreen, GetAll, Infinite };
-    Q_ENUM(GetDataOption)
 
-    static QString getToken();
-    static QFuture<QString> getTokenAsync();
+    // The token as entered; the wallet has it too once the dialog is accepted
+    QString token() const { return tokenEdit->text(); }
+
+    static QFuture<WalletManager::Result> getTokenAsync();
     static int getInterval();
-    static GetDataOption getGetDataOption();
+    static AppSettings::GetDataOption getGetDataOption();
     static int getSummaryThreshold();
     static int getNotificationDelayMs();
     static int getTrayUnreadLimit();
+    static int getHydrationPrefetchRows();
+    static int getAvatarCacheMb();
+    static QString getCustomSortKeys();
+    static void setCustomSortKeys(const QString& spec);
     static bool getNotifyOnce();
+    static int getKnownNotificationRetentionDays();
     static void setNotifyOnce(bool notify);
     static bool getNotifyRead();
     static void setNotifyRead(bool notify);
 
+   public slots:
+    void reject() override;
+
    private slots:
     void saveSettings();
     void onTestClicked();
@@ -37,6 +48,7 @@ class SettingsDialog : public QDialog {
     void installNotifyRc();
 
    private:
+    void applySettings();
     void updateAutostartEntry();
     bool isAutostartEnabled();
 
@@ -46,13 +58,21 @@ class SettingsDialog : public QDialog {
     QComboBox* summaryThresholdCombo;
     QComboBox* notificationDelayCombo;
     QComboBox* trayUnreadLimitCombo;
+    QComboBox* hydrationPrefetchCombo;
+    QComboBox* avatarCacheCombo;
     QCheckBox* autostartCheckBox;
     QCheckBox* startMinimizedCheckBox;
     QCheckBox* notifyOnceCheckBox;
+    QComboBox* knownRetentionCombo;
     QCheckBox* notifyReadCheckBox;
     QPushButton* testButton;
+    QPushButton* saveButton;
+    QPushButton* cancelButton;
     QLabel* statusLabel;
     GitHubClient* testClient;
+    QString m_walletToken;  // As read from the wallet, so an unchanged token is not written back
+    bool m_walletTokenLoaded;
+    bool m_savingToken;  // A wallet write is in flight; the dialog cannot be cancelled until it reports back
 };
 
 #endif  // SETTINGSDIALOG_H
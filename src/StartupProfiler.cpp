@@ -0,0 +1,78 @@
+#include "StartupProfiler.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QPair>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+QElapsedTimer s_clock;
+qint64 s_lastMarkNs = 0;
+QList<QPair<QString, qint64>> s_phases;  // Phase name, nanoseconds spent in it
+bool s_finished = false;
+
+QString formatMs(qint64 ns) { return QString::number(ns / 1e6, 'f', 1) + " ms"; }
+}  // namespace
+
+void StartupProfiler::start() {
+    s_clock.start();
+    s_lastMarkNs = 0;
+    s_phases.clear();
+    s_finished = false;
+}
+
+void StartupProfiler::mark(const QString& phase) {
+    if (s_finished || !s_clock.isValid()) return;
+
+    qint64 now = s_clock.nsecsElapsed();
+    s_phases.append({phase, now - s_lastMarkNs});
+    qDebug().noquote() << "Startup:" << phase << formatMs(now - s_lastMarkNs) << "(at" << formatMs(now) + ")";
+    s_lastMarkNs = now;
+}
+
+void StartupProfiler::finish() {
+    if (s_finished || !s_clock.isValid()) return;
+    mark(QStringLiteral("event loop"));
+    s_finished = true;
+
+    qDebug().noquote() << "Startup: reached the event loop after" << formatMs(s_lastMarkNs);
+
+    QString path = reportPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        file.write(report().join('\n').toUtf8() + '\n');
+        file.commit();
+    }
+}
+
+bool StartupProfiler::isFinished() { return s_finished; }
+
+QStringList StartupProfiler::report() {
+    QStringList lines;
+    QString arguments = QCoreApplication::arguments().mid(1).join(' ');
+    lines << QStringLiteral("Startup at %1, arguments: %2")
+                 .arg(QDateTime::currentDateTime().toString(Qt::ISODate), arguments.isEmpty() ? "none" : arguments);
+    for (const auto& phase : s_phases) {
+        lines << QStringLiteral("  %1 %2").arg(phase.first, -28).arg(formatMs(phase.second), 10);
+    }
+    lines << QStringLiteral("  %1 %2").arg(QStringLiteral("total"), -28).arg(formatMs(s_lastMarkNs), 10);
+    return lines;
+}
+
+QString StartupProfiler::reportPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/startup_profile.txt";
+}
+
+QStringList StartupProfiler::lastReport() {
+    QFile file(reportPath());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QStringList();
+    return QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+}
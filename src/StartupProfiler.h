@@ -0,0 +1,25 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QString>
+#include <QStringList>
+
+// Wall-clock phases of the current startup, measured from the start of main().
+//
+// Each phase is logged as it is marked. finish() is called once the event loop runs; it logs the total and
+// writes the report to a file so that `--diagnose` can show it later. The startups worth measuring are the
+// autostarted ones, and nobody watches those.
+class StartupProfiler {
+   public:
+    static void start();
+    // Records the time since the previous mark under the given phase name; ignored once finished
+    static void mark(const QString& phase);
+    static void finish();
+    static bool isFinished();
+
+    static QStringList report();
+    static QString reportPath();
+    static QStringList lastReport();
+};
+
+#endif  // STARTUPPROFILER_H
@@ -0,0 +1,21 @@
+#include "UpdateCoalescer.h"
+
+UpdateCoalescer::UpdateCoalescer(int intervalMs, QObject* parent)
+    : QObject(parent), m_timer(new QTimer(this)), m_pending(0) {
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(intervalMs);
+    connect(m_timer, &QTimer::timeout, this, &UpdateCoalescer::onTimeout);
+}
+
+void UpdateCoalescer::schedule() {
+    m_pending++;
+    if (!m_timer->isActive()) {
+        m_timer->start();
+    }
+}
+
+void UpdateCoalescer::onTimeout() {
+    int merged = m_pending;
+    m_pending = 0;
+    emit flush(merged);
+}
@@ -0,0 +1,28 @@
+#ifndef UPDATECOALESCER_H
+#define UPDATECOALESCER_H
+
+#include <QObject>
+#include <QTimer>
+
+// Collapses bursts of change requests into a single flush. Every schedule() call made before the timer fires is
+// merged into the same flush, and the number of merged requests is reported with it.
+class UpdateCoalescer : public QObject {
+    Q_OBJECT
+   public:
+    explicit UpdateCoalescer(int intervalMs = 16, QObject* parent = nullptr);
+
+    void schedule();
+    bool isPending() const { return m_pending > 0; }
+
+   signals:
+    void flush(int mergedCount);
+
+   private slots:
+    void onTimeout();
+
+   private:
+    QTimer* m_timer;
+    int m_pending;
+};
+
+#endif  // UPDATECOALESCER_H
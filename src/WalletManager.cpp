@@ -1,89 +1,186 @@
 #include "WalletManager.h"
 
 #include <KWallet>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QFutureInterface>
 #include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include "SecureString.h"
 
 namespace {
 const QString FOLDER_NAME = "Kgithub-notify";
 const QString KEY_NAME = "token";
+// Long enough for the user to answer an unlock prompt, short enough that a hung kwalletd is reported
+const int kOpenTimeoutMs = 2 * 60 * 1000;
+const qint64 kCacheLifetimeMs = 5 * 60 * 1000;
+
+// The last token read or written, kept locked in memory and wiped when it expires
+class TokenCache {
+   public:
+    bool get(QString* token) {
+        if (!m_valid) return false;
+        if (m_age.elapsed() >= kCacheLifetimeMs) {
+            clear();
+            return false;
+        }
+        *token = m_token.toQString();
+        return true;
+    }
+
+    void put(const QString& token) {
+        m_token.set(token);
+        m_valid = true;
+        m_age.start();
+        // Wipe on time even if nothing asks again
+        if (!m_expiryTimer && QCoreApplication::instance()) {
+            m_expiryTimer = new QTimer(QCoreApplication::instance());
+            m_expiryTimer->setSingleShot(true);
+            QObject::connect(m_expiryTimer, &QTimer::timeout, m_expiryTimer, [this]() { clear(); });
+        }
+        if (m_expiryTimer) m_expiryTimer->start(int(kCacheLifetimeMs));
+    }
+
+    void clear() {
+        m_token = SecureString();
+        m_valid = false;
+    }
+
+   private:
+    SecureString m_token;
+    bool m_valid = false;  // An empty token is cached too: it means none is configured
+    QElapsedTimer m_age;
+    QPointer<QTimer> m_expiryTimer;
+};
+
+// Bumped by every write, so a read that started before it cannot cache the token it replaced
+int s_writeGeneration = 0;
+
+TokenCache& tokenCache() {
+    static TokenCache cache;
+    return cache;
+}
+
+QFuture<WalletManager::Result> readyFuture(const WalletManager::Result& result) {
+    QFutureInterface<WalletManager::Result> interface;
+    interface.reportStarted();
+    interface.reportResult(result);
+    interface.reportFinished();
+    return interface.future();
+}
 }  // namespace
 
-class WalletLoader : public QObject {
+// One wallet round trip: open asynchronously, then read or write the token and report the outcome
+class WalletJob : public QObject {
     Q_OBJECT
    public:
-    WalletLoader() { interface.reportStarted(); }
+    explicit WalletJob(bool write, const QString& token = QString())
+        : m_write(write), m_generation(write ? ++s_writeGeneration : s_writeGeneration), m_token(token) {
+        m_interface.reportStarted();
+    }
 
-    QFuture<QString> start() {
-        wallet = KWallet::Wallet::openWallet(KWallet::Wallet::LocalWallet(), 0, KWallet::Wallet::Asynchronous);
-        if (wallet) {
-            connect(wallet, &KWallet::Wallet::walletOpened, this, &WalletLoader::onWalletOpened);
-        } else {
-            interface.reportResult(QString());
-            interface.reportFinished();
-            deleteLater();
+    QFuture<WalletManager::Result> start() {
+        QFuture<WalletManager::Result> future = m_interface.future();
+        m_wallet = KWallet::Wallet::openWallet(KWallet::Wallet::LocalWallet(), 0, KWallet::Wallet::Asynchronous);
+        if (!m_wallet) {
+            finish(WalletManager::Result::Unavailable);
+            return future;
         }
-        return interface.future();
+        connect(m_wallet, &KWallet::Wallet::walletOpened, this, &WalletJob::onWalletOpened);
+        QTimer::singleShot(kOpenTimeoutMs, this, [this]() { finish(WalletManager::Result::TimedOut); });
+        return future;
     }
 
    private slots:
     void onWalletOpened(bool success) {
-        if (success && wallet) {
-            if (!wallet->hasFolder(FOLDER_NAME)) {
-                wallet->createFolder(FOLDER_NAME);
+        if (!success || !m_wallet) {
+            finish(WalletManager::Result::OpenFailed);
+            return;
+        }
+
+        // The wallet is open and unlocked from here, so these calls return without user interaction
+        if (!m_wallet->hasFolder(FOLDER_NAME)) {
+            m_wallet->createFolder(FOLDER_NAME);
+        }
+        m_wallet->setFolder(FOLDER_NAME);
+        if (m_write) {
+            if (m_wallet->writePassword(KEY_NAME, m_token) != 0) {
+                finish(WalletManager::Result::WriteFailed);
+                return;
             }
-            wallet->setFolder(FOLDER_NAME);
-            QString token;
-            wallet->readPassword(KEY_NAME, token);
-            interface.reportResult(token);
         } else {
-            interface.reportResult(QString());
+            m_wallet->readPassword(KEY_NAME, m_token);
         }
-        interface.reportFinished();
-        if (wallet) {
-            wallet->deleteLater();
-            wallet = nullptr;
+        if (m_generation == s_writeGeneration) tokenCache().put(m_token);
+        finish(WalletManager::Result::Ok);
+    }
+
+   private:
+    void finish(WalletManager::Result::Status status) {
+        if (m_finished) return;
+        m_finished = true;
+
+        WalletManager::Result result;
+        result.status = status;
+        if (status == WalletManager::Result::Ok) result.token = m_token;
+        if (!result.ok()) qWarning() << "Wallet" << (m_write ? "write" : "read") << "failed:" << result.errorString();
+
+        m_interface.reportResult(result);
+        m_interface.reportFinished();
+        if (m_wallet) {
+            // A late walletOpened from a timed-out open must not reach this job
+            m_wallet->disconnect(this);
+            m_wallet->deleteLater();
+            m_wallet = nullptr;
         }
         deleteLater();
     }
 
-   private:
-    KWallet::Wallet* wallet = nullptr;
-    QFutureInterface<QString> interface;
+    bool m_write;
+    int m_generation;
+    bool m_finished = false;
+    QString m_token;
+    KWallet::Wallet* m_wallet = nullptr;
+    QFutureInterface<WalletManager::Result> m_interface;
 };
 
-QString WalletManager::loadToken() {
-    KWallet::Wallet* wallet =
-        KWallet::Wallet::openWallet(KWallet::Wallet::LocalWallet(), 0, KWallet::Wallet::Synchronous);
-    if (wallet) {
-        if (!wallet->hasFolder(FOLDER_NAME)) {
-            wallet->createFolder(FOLDER_NAME);
-        }
-        wallet->setFolder(FOLDER_NAME);
-        QString token;
-        wallet->readPassword(KEY_NAME, token);
-        delete wallet;
-        return token;
+QString WalletManager::Result::errorString() const {
+    switch (status) {
+        case Ok:
+            return QString();
+        case Unavailable:
+            return QObject::tr("KWallet is disabled or not available");
+        case OpenFailed:
+            return QObject::tr("the wallet could not be opened");
+        case TimedOut:
+            return QObject::tr("the wallet did not respond in time");
+        case WriteFailed:
+            return QObject::tr("the token could not be written to the wallet");
     }
     return QString();
 }
 
-QFuture<QString> WalletManager::loadTokenAsync() {
-    WalletLoader* loader = new WalletLoader();
-    return loader->start();
+QFuture<WalletManager::Result> WalletManager::loadTokenAsync() {
+    Result cached;
+    if (tokenCache().get(&cached.token)) return readyFuture(cached);
+
+    // Concurrent lookups share the round trip that is already under way
+    static QFuture<Result> pending;
+    if (pending.isValid() && !pending.isFinished()) return pending;
+
+    WalletJob* job = new WalletJob(false);
+    pending = job->start();
+    return pending;
 }
 
-void WalletManager::saveToken(const QString& token) {
-    KWallet::Wallet* wallet =
-        KWallet::Wallet::openWallet(KWallet::Wallet::LocalWallet(), 0, KWallet::Wallet::Synchronous);
-    if (wallet) {
-        if (!wallet->hasFolder(FOLDER_NAME)) {
-            wallet->createFolder(FOLDER_NAME);
-        }
-        wallet->setFolder(FOLDER_NAME);
-        wallet->writePassword(KEY_NAME, token);
-        delete wallet;
-    }
+QFuture<WalletManager::Result> WalletManager::saveTokenAsync(const QString& token) {
+    WalletJob* job = new WalletJob(true, token);
+    return job->start();
 }
 
+void WalletManager::clearCache() { tokenCache().clear(); }
+
 #include "WalletManager.moc"
@@ -4,11 +4,26 @@
 #include <QFuture>
 #include <QString>
 
+// Token storage in KWallet. Every operation is asynchronous: opening the wallet can wait on kwalletd or on the
+// user at an unlock prompt, and none of that may hold up the GUI thread.
+//
+// A token that was just read or written is kept in memory for a few minutes, so lookups made close together
+// (start-up, then the settings dialog) do not go back to the wallet. The cached copy is wiped on expiry.
 class WalletManager {
    public:
-    static QString loadToken();
-    static QFuture<QString> loadTokenAsync();
-    static void saveToken(const QString& token);
+    struct Result {
+        enum Status { Ok, Unavailable, OpenFailed, TimedOut, WriteFailed };
+
+        Status status = Ok;
+        QString token;  // Empty when no token has been stored yet
+
+        bool ok() const { return status == Ok; }
+        QString errorString() const;
+    };
+
+    static QFuture<Result> loadTokenAsync();
+    static QFuture<Result> saveTokenAsync(const QString& token);
+    static void clearCache();
 };
 
 #endif  // WALLETMANAGER_H
@@ -12,15 +12,70 @@
 #include <QTimer>
 #include <QtDBus/QDBusConnection>
 #include <QtDBus/QDBusError>
+#include <memory>
 
 #include "GitHubClient.h"
 #include "MainWindow.h"
+#include "NotificationDaemon.h"
+#include "StartupProfiler.h"
 
 #ifndef KGHN_APP_VERSION
 #define KGHN_APP_VERSION "dev"
 #endif
 
+static QString desktopFileName() { return QGuiApplication::desktopFileName() + ".desktop"; }
+
+static bool isDesktopFileInstalled(const QStringList& appPaths) {
+    for (const QString& path : appPaths) {
+        if (QFileInfo::exists(path + "/" + desktopFileName())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Installs the bundled desktop file for the user if none is found, and warns in the window otherwise
+static void checkDesktopFile(MainWindow* window) {
+    QStringList appPaths = QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation);
+    if (isDesktopFileInstalled(appPaths)) return;
+
+    QString userAppsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
+    QString destPath = userAppsPath + "/" + desktopFileName();
+    bool copied = false;
+
+    if (QFile::exists(":/kgithub-notify.desktop")) {
+        // Ensure the directory exists
+        QDir dir(userAppsPath);
+        if (!dir.exists()) {
+            dir.mkpath(".");
+        }
+        if (QFile::copy(":/kgithub-notify.desktop", destPath)) {
+            // Set appropriate permissions
+            QFile::setPermissions(destPath,
+                                  QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup | QFile::ReadOther);
+            copied = true;
+        }
+    }
+
+    if (!copied) {
+        qWarning() << "Warning: Desktop file" << desktopFileName() << "not found in standard locations.";
+        qWarning() << "System tray and notifications may not work correctly with portals.";
+
+        window->showDesktopFileWarning(desktopFileName(), appPaths);
+    }
+}
+
+// Checked before the application object exists, since the daemon runs on a plain QGuiApplication
+static bool isDaemonRequested(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--daemon") == 0) return true;
+    }
+    return false;
+}
+
 int main(int argc, char* argv[]) {
+    StartupProfiler::start();
+
     QCoreApplication::setOrganizationName("arran4");
     QCoreApplication::setOrganizationDomain("arran4.com");
     QCoreApplication::setApplicationName("kgithub-notify");
@@ -28,7 +83,9 @@ int main(int argc, char* argv[]) {
     QGuiApplication::setDesktopFileName("com.arran4.kgithub_notify");
     QApplication::setQuitOnLastWindowClosed(false);
 
-    QApplication app(argc, argv);
+    std::unique_ptr<QGuiApplication> app(isDaemonRequested(argc, argv) ? new QGuiApplication(argc, argv)
+                                                                        : new QApplication(argc, argv));
+    StartupProfiler::mark(QStringLiteral("application"));
     QApplication::setWindowIcon(QIcon::fromTheme("kgithub-notify", QIcon(":/assets/icon.png")));
 
     KLocalizedString::setApplicationDomain("kgithub-notify");
@@ -53,32 +110,27 @@ int main(int argc, char* argv[]) {
                                       QCoreApplication::translate("main", "Run self-diagnostics and exit."));
     parser.addOption(diagnoseOption);
 
-    parser.process(app);
+    QCommandLineOption daemonOption(
+        QStringList() << "daemon",
+        QCoreApplication::translate("main", "Run without a window, serving notifications over D-Bus."));
+    parser.addOption(daemonOption);
 
-    // Check for desktop file to warn about potential portal issues
-    QString desktopFileName = QGuiApplication::desktopFileName() + ".desktop";
-    bool desktopFileFound = false;
-    QStringList appPaths = QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation);
-    for (const QString& path : appPaths) {
-        if (QFileInfo::exists(path + "/" + desktopFileName)) {
-            desktopFileFound = true;
-            break;
-        }
-    }
+    parser.process(*app);
 
     if (parser.isSet(diagnoseOption)) {
         qDebug() << "=== KGitHub Notify Diagnostics ===";
         qDebug() << "App Name:" << QCoreApplication::applicationName();
         qDebug() << "Desktop File Name:" << QGuiApplication::desktopFileName();
-        qDebug() << "Looking for Desktop File:" << desktopFileName;
+        qDebug() << "Looking for Desktop File:" << desktopFileName();
 
+        QStringList appPaths = QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation);
         qDebug() << "Standard Applications Paths:" << appPaths;
 
-        if (desktopFileFound) {
+        if (isDesktopFileInstalled(appPaths)) {
             qDebug() << "Desktop File Status: [FOUND]";
         } else {
             qDebug() << "Desktop File Status: [MISSING]";
-            qDebug() << "  -> Ensure" << desktopFileName << "is installed to one of the above paths.";
+            qDebug() << "  -> Ensure" << desktopFileName() << "is installed to one of the above paths.";
         }
 
         if (QDBusConnection::sessionBus().isConnected()) {
@@ -89,45 +141,46 @@ int main(int argc, char* argv[]) {
             qDebug() << "  -> Error:" << QDBusConnection::sessionBus().lastError().message();
         }
 
+        // This run is not a representative start; show the last real one, which is usually an autostart
+        QStringList startupProfile = StartupProfiler::lastReport();
+        if (startupProfile.isEmpty()) {
+            qDebug() << "Last Startup Profile: [NONE]" << StartupProfiler::reportPath();
+        } else {
+            qDebug() << "Last Startup Profile:";
+            for (const QString& line : startupProfile) {
+                qDebug().noquote() << " " << line;
+            }
+        }
+
         return 0;
     }
 
+    if (parser.isSet(daemonOption)) {
+        GitHubClient client;
+        NotificationDaemon daemon(&client);
+        if (!daemon.registerOnBus()) {
+            return 1;
+        }
+        StartupProfiler::mark(QStringLiteral("daemon"));
+        QTimer::singleShot(0, &daemon, []() { StartupProfiler::finish(); });
+        return app->exec();
+    }
+
     MainWindow window;
     GitHubClient client;
 
     window.setClient(&client);
-
-    if (!desktopFileFound) {
-        QString userAppsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
-        QString destPath = userAppsPath + "/" + desktopFileName;
-        bool copied = false;
-
-        if (QFile::exists(":/kgithub-notify.desktop")) {
-            // Ensure the directory exists
-            QDir dir(userAppsPath);
-            if (!dir.exists()) {
-                dir.mkpath(".");
-            }
-            if (QFile::copy(":/kgithub-notify.desktop", destPath)) {
-                // Set appropriate permissions
-                QFile::setPermissions(destPath,
-                                      QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup | QFile::ReadOther);
-                copied = true;
-                desktopFileFound = true;
-            }
-        }
-
-        if (!copied) {
-            qWarning() << "Warning: Desktop file" << desktopFileName << "not found in standard locations.";
-            qWarning() << "System tray and notifications may not work correctly with portals.";
-
-            window.showDesktopFileWarning(desktopFileName, appPaths);
-        }
-    }
+    StartupProfiler::mark(QStringLiteral("main window"));
 
     if (!parser.isSet(backgroundOption)) {
         window.show();
     }
 
-    return app.exec();
+    // Nothing here is needed to show the tray icon, so it waits until the event loop is running
+    QTimer::singleShot(0, &window, [&window]() {
+        StartupProfiler::finish();
+        checkDesktopFile(&window);
+    });
+
+    return app->exec();
 }
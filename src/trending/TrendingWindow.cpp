@@ -21,9 +21,15 @@
 #include <QUrl>
 #include <QtGui/QAction>
 
+#include "../AvatarStore.h"
 #include "../GitHubClient.h"
 #include "../NewIssueDialog.h"
 
+namespace {
+// Name/login items carry their avatar URL so a late image finds every row that shows it
+const int kAvatarUrlRole = Qt::UserRole + 3;
+}  // namespace
+
 TrendingWindow::TrendingWindow(GitHubClient* client, QWidget* parent)
     : KXmlGuiWindow(parent, Qt::Window), m_client(client) {
     setWindowTitle(tr("Trending Repos & Devs"));
@@ -113,6 +119,7 @@ TrendingWindow::TrendingWindow(GitHubClient* client, QWidget* parent)
 
     m_netManager = new QNetworkAccessManager(this);
     connect(m_netManager, &QNetworkAccessManager::finished, this, &TrendingWindow::onRepoStarredCheckFinished);
+    connect(AvatarStore::instance(), &AvatarStore::avatarReady, this, &TrendingWindow::onAvatarReady);
 
     connect(refreshButton, &QPushButton::clicked, this, &TrendingWindow::onRefreshClicked);
     connect(modeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &TrendingWindow::onModeChanged);
@@ -318,6 +325,7 @@ void TrendingWindow::onRawDataReceived(const QByteArray& data) {
             nameItem->setData(Qt::UserRole, htmlUrl);
             nameItem->setData(Qt::UserRole + 1, rawJson);
             nameItem->setFont(font);
+            setAvatar(nameItem, itemObj["owner"].toObject()["avatar_url"].toString());
             QTableWidgetItem* starsItem = new QTableWidgetItem(stars);
             starsItem->setData(Qt::UserRole, htmlUrl);
             starsItem->setData(Qt::UserRole + 1, rawJson);
@@ -360,6 +368,7 @@ void TrendingWindow::onRawDataReceived(const QByteArray& data) {
             loginItem->setData(Qt::UserRole, htmlUrl);
             loginItem->setData(Qt::UserRole + 1, rawJson);
             loginItem->setFont(font);
+            setAvatar(loginItem, itemObj["avatar_url"].toString());
 
             QLabel* linkLabel = new QLabel(QString("<a href='%1'>%1</a>").arg(htmlUrl));
             linkLabel->setOpenExternalLinks(true);
@@ -447,3 +456,26 @@ void TrendingWindow::onItemSelectionChanged() {
         settings.setValue("seen_urls", QStringList(m_selectedUrls.begin(), m_selectedUrls.end()));
     }
 }
+
+void TrendingWindow::setAvatar(QTableWidgetItem* item, const QString& avatarUrl) {
+    if (avatarUrl.isEmpty()) return;
+    item->setData(kAvatarUrlRole, avatarUrl);
+
+    QPixmap pixmap = AvatarStore::instance()->avatar(avatarUrl);
+    if (!pixmap.isNull()) {
+        item->setIcon(QIcon(pixmap));
+    } else {
+        AvatarStore::instance()->request(avatarUrl);
+    }
+}
+
+void TrendingWindow::onAvatarReady(const QString& url, const QPixmap& pixmap) {
+    // Owners of several trending repositories share one fetch, so every row with this avatar is updated
+    int column = modeComboBox->currentIndex() == 0 ? 1 : 0;
+    for (int row = 0; row < tableWidget->rowCount(); ++row) {
+        QTableWidgetItem* item = tableWidget->item(row, column);
+        if (item && item->data(kAvatarUrlRole).toString() == url) {
+            item->setIcon(QIcon(pixmap));
+        }
+    }
+}
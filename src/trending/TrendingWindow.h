@@ -28,8 +28,11 @@ class TrendingWindow : public KXmlGuiWindow {
     void onRawDataReceived(const QByteArray& data);
     void onRepoStarredCheckFinished(QNetworkReply* reply);
     void onItemSelectionChanged();
+    void onAvatarReady(const QString& url, const QPixmap& pixmap);
 
    private:
+    void setAvatar(QTableWidgetItem* item, const QString& avatarUrl);
+
     QComboBox* modeComboBox;
     QComboBox* timeframeComboBox;
     QComboBox* langComboBox;
@@ -0,0 +1,82 @@
+#include <QSettings>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QtTest>
+
+#include "../src/AppSettings.h"
+
+class TestAppSettings : public QObject {
+    Q_OBJECT
+   private slots:
+    void initTestCase() {
+        QStandardPaths::setTestModeEnabled(true);
+        QCoreApplication::setOrganizationName("kgithub-notify-tests");
+        QCoreApplication::setApplicationName("TestAppSettings");
+        QSettings().clear();
+        AppSettings::instance()->reload();
+    }
+
+    void cleanupTestCase() { QSettings().clear(); }
+
+    void testDefaults() {
+        AppSettings* settings = AppSettings::instance();
+        QCOMPARE(settings->interval(), 5);
+        QCOMPARE(settings->notificationDelayMs(), 1000);
+        QCOMPARE(settings->customSortKeys(), QString("repository,reason,-updated"));
+        QVERIFY(settings->notifyOnce());
+        QVERIFY(!settings->notifyRead());
+    }
+
+    void testSetValueSignalsOnlyChanges() {
+        AppSettings* settings = AppSettings::instance();
+        QSignalSpy spy(settings, &AppSettings::valueChanged);
+
+        settings->setValue("interval", 15);
+        QCOMPARE(settings->interval(), 15);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.takeFirst().at(0).toString(), QString("interval"));
+
+        settings->setValue("interval", 15);
+        QCOMPARE(spy.count(), 0);
+    }
+
+    void testReloadPicksUpDirectWrites() {
+        AppSettings* settings = AppSettings::instance();
+        QSignalSpy spy(settings, &AppSettings::valueChanged);
+
+        {
+            QSettings direct;
+            direct.setValue("trayUnreadLimit", 9);
+            direct.setValue("notifyRead", true);
+        }
+        // Nothing changes until a reload, which is what keeps the getters cheap
+        QCOMPARE(settings->trayUnreadLimit(), 5);
+
+        settings->reload();
+        QCOMPARE(settings->trayUnreadLimit(), 9);
+        QVERIFY(settings->notifyRead());
+        QCOMPARE(spy.count(), 2);
+    }
+
+    void testWatchedFileReloads() {
+        AppSettings* settings = AppSettings::instance();
+        settings->setValue("summaryThreshold", 3);
+        settings->setWatchFile(true);
+        QVERIFY(settings->isWatchingFile());
+        QSignalSpy spy(settings, &AppSettings::valueChanged);
+
+        {
+            QSettings direct;
+            direct.setValue("summaryThreshold", 7);
+            direct.sync();
+        }
+        QTRY_COMPARE(settings->summaryThreshold(), 7);
+        QCOMPARE(spy.count(), 1);
+
+        settings->setWatchFile(false);
+        QVERIFY(!settings->isWatchingFile());
+    }
+};
+
+QTEST_MAIN(TestAppSettings)
+#include "TestAppSettings.moc"
@@ -68,6 +68,49 @@ class TestGitHubClient : public QObject {
         QCOMPARE(hasMore, true);
     }
 
+    void testNotModifiedDispatch() {
+        GitHubClient client;
+        QSignalSpy received(&client, &GitHubClient::notificationsReceived);
+        QSignalSpy unchanged(&client, &GitHubClient::notificationsUnchanged);
+        QSignalSpy hints(&client, &GitHubClient::pollHintsReceived);
+
+        MockNetworkReply* reply = new MockNetworkReply(QByteArray(), &client);
+        reply->setProperty("type", "notifications");
+        reply->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 304);
+        reply->setRawHeader("X-Poll-Interval", "60");
+        reply->setRawHeader("X-RateLimit-Remaining", "4999");
+
+        QMetaObject::invokeMethod(&client, "onReplyFinished", Qt::DirectConnection, Q_ARG(QNetworkReply*, reply));
+
+        QCOMPARE(received.count(), 0);
+        QCOMPARE(unchanged.count(), 1);
+        QCOMPARE(hints.count(), 1);
+        QList<QVariant> args = hints.takeFirst();
+        QCOMPARE(args.at(0).toInt(), 60);
+        QCOMPARE(args.at(1).toInt(), 4999);
+        QCOMPARE(args.at(2).toLongLong(), qint64(-1));
+    }
+
+    void testReposFailureIsNotAPollFailure() {
+        GitHubClient client;
+        QSignalSpy failed(&client, &GitHubClient::notificationsFailed);
+        QSignalSpy errors(&client, &GitHubClient::errorOccurred);
+
+        MockNetworkReply* reply = new MockNetworkReply("", &client);
+        reply->setProperty("type", "repos");
+        reply->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 500);
+        reply->setError(QNetworkReply::InternalServerError, "Server Error");
+        QMetaObject::invokeMethod(&client, "onReplyFinished", Qt::DirectConnection, Q_ARG(QNetworkReply*, reply));
+
+        MockNetworkReply* malformed = new MockNetworkReply("{}", &client);
+        malformed->setProperty("type", "repos");
+        malformed->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+        QMetaObject::invokeMethod(&client, "onReplyFinished", Qt::DirectConnection, Q_ARG(QNetworkReply*, malformed));
+
+        QCOMPARE(errors.count(), 2);
+        QCOMPARE(failed.count(), 0);
+    }
+
     void testDetailsDispatch() {
         GitHubClient client;
         QSignalSpy spy(&client, &GitHubClient::detailsReceived);
@@ -105,6 +148,17 @@ class TestGitHubClient : public QObject {
         QCOMPARE(args.at(1).toString(), QString("Not Found"));
     }
 
+    void testUnsentDetailsRequestIsAnswered() {
+        GitHubClient client;
+        QSignalSpy spy(&client, &GitHubClient::detailsError);
+
+        // No token yet: nothing goes out, but the caller still hears back for the id
+        client.fetchNotificationDetails("https://api.github.com/repos/foo/bar/issues/1", "123");
+
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.takeFirst().at(0).toString(), QString("123"));
+    }
+
     void testVerificationDispatch() {
         GitHubClient client;
         QSignalSpy spy(&client, &GitHubClient::tokenVerified);
@@ -0,0 +1,64 @@
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "../src/KnownNotificationStore.h"
+
+class TestKnownNotificationStore : public QObject {
+    Q_OBJECT
+   private slots:
+    void initTestCase() { QStandardPaths::setTestModeEnabled(true); }
+
+    void testReplaysLogAcrossInstances() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("known.log");
+
+        {
+            KnownNotificationStore store(path);
+            store.load(0);
+            QVERIFY(store.insert("1"));
+            QVERIFY(store.insert("2"));
+            QVERIFY(!store.insert("1"));
+            store.remove("2");
+        }
+
+        KnownNotificationStore reloaded(path);
+        reloaded.load(0);
+        QVERIFY(reloaded.contains("1"));
+        QVERIFY(!reloaded.contains("2"));
+        QCOMPARE(reloaded.size(), 1);
+    }
+
+    void testPrunesExpiredEntries() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("known.log");
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        qint64 now = QDateTime::currentSecsSinceEpoch();
+        file.write("+old\t" + QByteArray::number(now - 40 * 24 * 60 * 60) + "\n");
+        file.write("+new\t" + QByteArray::number(now) + "\n");
+        file.close();
+
+        KnownNotificationStore store(path);
+        store.load(30);
+        QVERIFY(!store.contains("old"));
+        QVERIFY(store.contains("new"));
+
+        // Pruning rewrites the log so the expired line is gone for good
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(!file.readAll().contains("old"));
+    }
+
+    void testMemoryOnlyWhenPathEmpty() {
+        KnownNotificationStore store(QString());
+        store.load(30);
+        QVERIFY(store.insert("1"));
+        store.flush();
+        QVERIFY(store.contains("1"));
+    }
+};
+
+QTEST_MAIN(TestKnownNotificationStore)
+#include "TestKnownNotificationStore.moc"
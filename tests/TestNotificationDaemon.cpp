@@ -0,0 +1,125 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPromise>
+#include <QSettings>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QtTest>
+
+#include "../src/AppSettings.h"
+#include "../src/GitHubClient.h"
+#include "../src/NotificationDaemon.h"
+
+class TestNotificationDaemon : public QObject {
+    Q_OBJECT
+   private:
+    static Notification make(const QString& id, const QString& repo, const QString& reason, bool unread) {
+        Notification n;
+        n.id = id;
+        n.repository = repo;
+        n.title = QString("Title %1").arg(id);
+        n.reason = reason;
+        n.unread = unread;
+        n.updatedAt = QString("2024-01-0%1T00:00:00Z").arg(id);
+        return n;
+    }
+
+    // Stands in for the wallet, which a test run must never open: the result is ready and holds no token
+    static QFuture<WalletManager::Result> noToken() {
+        QPromise<WalletManager::Result> promise;
+        promise.start();
+        promise.addResult(WalletManager::Result());
+        promise.finish();
+        return promise.future();
+    }
+
+    static QStringList ids(const QString& json) {
+        QStringList result;
+        for (const QJsonValue& value : QJsonDocument::fromJson(json.toUtf8()).array()) {
+            result << value.toObject()["id"].toString();
+        }
+        return result;
+    }
+
+   private slots:
+    void initTestCase() {
+        QStandardPaths::setTestModeEnabled(true);
+        QCoreApplication::setOrganizationName("kgithub-notify-tests");
+        QCoreApplication::setApplicationName("TestNotificationDaemon");
+        QSettings().clear();
+        // Keep the known-thread log in memory
+        AppSettings::instance()->setValue("notifyOnce", false);
+    }
+
+    void cleanupTestCase() { QSettings().clear(); }
+
+    void testCountsAndListing() {
+        GitHubClient client;
+        NotificationDaemon daemon(&client, noToken);
+        QSignalSpy countsSpy(&daemon, &NotificationDaemon::countsChanged);
+        QSignalSpy changedSpy(&daemon, &NotificationDaemon::notificationsChanged);
+
+        emit client.notificationsReceived({make("1", "a/a", "mention", true), make("2", "b/b", "subscribed", true),
+                                           make("3", "a/a", "subscribed", false)},
+                                          false, false);
+
+        QCOMPARE(daemon.totalCount(), 3);
+        QCOMPARE(daemon.unreadCount(), 2);
+        QCOMPARE(changedSpy.count(), 1);
+        QVERIFY(countsSpy.count() >= 1);
+        QCOMPARE(daemon.repositories().size(), 2);
+
+        // Newest first
+        QCOMPARE(ids(daemon.listNotifications(4, QString(), QString())), QStringList({"3", "2", "1"}));
+        QCOMPARE(ids(daemon.listNotifications(0, QString(), QString())), QStringList({"2", "1"}));
+        QCOMPARE(ids(daemon.listNotifications(4, "a/a", QString())), QStringList({"3", "1"}));
+        QCOMPARE(ids(daemon.listNotifications(5, QString(), QString())), QStringList({"1"}));
+
+        QCOMPARE(QJsonDocument::fromJson(daemon.notification("2").toUtf8()).object()["repository"].toString(),
+                 QString("b/b"));
+        QVERIFY(daemon.notification("missing").isEmpty());
+    }
+
+    void testMarkReadAndDone() {
+        GitHubClient client;
+        NotificationDaemon daemon(&client, noToken);
+        emit client.notificationsReceived({make("1", "a/a", "mention", true), make("2", "b/b", "mention", true)},
+                                          false, false);
+
+        QVERIFY(daemon.markAsRead("1"));
+        QCOMPARE(daemon.unreadCount(), 1);
+        QCOMPARE(daemon.totalCount(), 2);
+
+        QVERIFY(daemon.markAsDone("2"));
+        QCOMPARE(daemon.totalCount(), 1);
+        QCOMPARE(daemon.unreadCount(), 0);
+
+        QVERIFY(!daemon.markAsRead("missing"));
+        QVERIFY(!daemon.markAsDone("2"));
+    }
+
+    void testStatusWithoutToken() {
+        GitHubClient client;
+        NotificationDaemon daemon(&client, noToken);
+        QSignalSpy statusSpy(&daemon, &NotificationDaemon::statusChanged);
+
+        QVERIFY(statusSpy.wait(1000));
+        QVERIFY(daemon.status().startsWith("No token"));
+    }
+
+    void testAppendedPagesExtendTheList() {
+        GitHubClient client;
+        NotificationDaemon daemon(&client, noToken);
+        emit client.notificationsReceived({make("1", "a/a", "mention", true)}, false, true);
+        emit client.notificationsReceived({make("2", "a/a", "mention", true)}, true, false);
+        QCOMPARE(daemon.totalCount(), 2);
+
+        // A fresh first page replaces everything
+        emit client.notificationsReceived({make("3", "a/a", "mention", true)}, false, false);
+        QCOMPARE(daemon.totalCount(), 1);
+    }
+};
+
+QTEST_MAIN(TestNotificationDaemon)
+#include "TestNotificationDaemon.moc"
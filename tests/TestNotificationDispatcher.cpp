@@ -0,0 +1,86 @@
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "../src/NotificationDispatcher.h"
+
+class TestNotificationDispatcher : public QObject {
+    Q_OBJECT
+   private:
+    static Notification make(const QString& id, const QString& repo, const QString& title = QString()) {
+        Notification n;
+        n.id = id;
+        n.repository = repo;
+        n.title = title.isEmpty() ? QString("Title %1").arg(id) : title;
+        n.unread = true;
+        return n;
+    }
+
+   private slots:
+    void testBurstThenRateLimited() {
+        NotificationDispatcher dispatcher;
+        dispatcher.setRate(200, 2);
+        dispatcher.setCoalesceThreshold(100);
+        QSignalSpy spy(&dispatcher, &NotificationDispatcher::notificationReady);
+
+        dispatcher.enqueue(make("1", "a/a"));
+        dispatcher.enqueue(make("2", "b/b"));
+        dispatcher.enqueue(make("3", "c/c"));
+
+        QTRY_COMPARE(spy.count(), 2);
+        QCOMPARE(dispatcher.queueDepth(), 1);
+        QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 3, 2000);
+        QCOMPARE(spy.at(2).at(0).value<Notification>().id, QString("3"));
+    }
+
+    void testSameThreadReplacesAndReadCancels() {
+        NotificationDispatcher dispatcher;
+        dispatcher.setRate(1000, 1);
+        dispatcher.setCoalesceThreshold(100);
+        QSignalSpy spy(&dispatcher, &NotificationDispatcher::notificationReady);
+
+        dispatcher.enqueue(make("1", "a/a"));
+        QTRY_COMPARE(spy.count(), 1);
+
+        dispatcher.enqueue(make("2", "a/a", "old"));
+        dispatcher.enqueue(make("2", "a/a", "new"));
+        dispatcher.enqueue(make("3", "a/a"));
+        QCOMPARE(dispatcher.queueDepth(), 2);
+
+        QVERIFY(dispatcher.threadRead("3"));
+        QVERIFY(!dispatcher.threadRead("3"));
+        QCOMPARE(dispatcher.cancelledCount(), 1);
+
+        QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 2, 3000);
+        QCOMPARE(spy.at(1).at(0).value<Notification>().title, QString("new"));
+        QCOMPARE(dispatcher.queueDepth(), 0);
+    }
+
+    void testBoundedQueueAndCoalescing() {
+        NotificationDispatcher dispatcher;
+        dispatcher.setRate(1000, 1);
+        dispatcher.setMaxQueue(4);
+        dispatcher.setCoalesceThreshold(2);
+        QSignalSpy single(&dispatcher, &NotificationDispatcher::notificationReady);
+        QSignalSpy summary(&dispatcher, &NotificationDispatcher::summaryReady);
+
+        // Nothing is released until the event loop runs, so the queue fills up first
+        dispatcher.enqueue(make("1", "x/x"));
+        dispatcher.enqueue(make("2", "a/a"));
+        dispatcher.enqueue(make("3", "b/b"));
+        dispatcher.enqueue(make("4", "a/a"));
+        dispatcher.enqueue(make("5", "a/a"));
+        QCOMPARE(dispatcher.queueDepth(), 4);
+        QCOMPARE(dispatcher.droppedCount(), 1);
+
+        // With a backlog the head is released together with the rest of its repository
+        QTRY_COMPARE(summary.count(), 1);
+        QList<Notification> group = summary.at(0).at(0).value<QList<Notification>>();
+        QCOMPARE(group.size(), 3);
+        QCOMPARE(dispatcher.coalescedCount(), 2);
+        QCOMPARE(dispatcher.queueDepth(), 1);
+        QCOMPARE(single.count(), 0);
+    }
+};
+
+QTEST_MAIN(TestNotificationDispatcher)
+#include "TestNotificationDispatcher.moc"
@@ -0,0 +1,116 @@
+#include <QtTest>
+
+#include "../src/NotificationRuleEngine.h"
+
+class TestNotificationRuleEngine : public QObject {
+    Q_OBJECT
+   private:
+    static Notification make(const QString& repo, const QString& type = "Issue", const QString& reason = "subscribed",
+                             const QString& title = "Title") {
+        Notification n;
+        n.repository = repo;
+        n.type = type;
+        n.reason = reason;
+        n.title = title;
+        n.unread = true;
+        return n;
+    }
+
+    static NotificationRule rule(const QString& repo, const QString& action, const QString& reason = QString()) {
+        NotificationRule r;
+        r.repoFilter = repo;
+        r.reasonFilter = reason;
+        r.action = action;
+        return r;
+    }
+
+   private slots:
+    void testRepoFilterForms() {
+        NotificationRuleSet rules({rule("Foo/Bar", "Mute"), rule("owner/*", "AlwaysIndividual"),
+                                   rule("*/docs?", "AlwaysSummarize")});
+
+        QCOMPARE(rules.match(make("foo/bar")), 0);
+        QCOMPARE(rules.match(make("foo/barn")), -1);
+        QCOMPARE(rules.match(make("Owner/anything")), 1);
+        // The wildcard does not cross '/', the same as the pattern conversion
+        QCOMPARE(rules.match(make("owner/a/b")), -1);
+        QCOMPARE(rules.match(make("someone/docs2")), 2);
+        QCOMPARE(rules.actionAt(2), QString("AlwaysSummarize"));
+        QCOMPARE(rules.actionAt(-1), QString("Default"));
+    }
+
+    void testFirstMatchPriorityAcrossIndexes() {
+        // An unindexed rule listed before an exact repo rule must still win, and vice versa
+        NotificationRuleSet rules({rule("", "AlwaysIndividual", "mention"), rule("foo/bar", "Mute"),
+                                   rule("foo/*", "NeverIndividual"), rule("!other/*", "AlwaysSummarize")});
+
+        QCOMPARE(rules.match(make("foo/bar", "Issue", "mention")), 0);
+        QCOMPARE(rules.match(make("foo/bar")), 1);
+        QCOMPARE(rules.match(make("foo/baz")), 2);
+        QCOMPARE(rules.match(make("bar/baz")), 3);
+        QCOMPARE(rules.match(make("other/baz")), -1);
+    }
+
+    void testDefaultRulesAndTextFilters() {
+        NotificationRule byType;
+        byType.typeFilter = "pull";
+        byType.action = "Mute";
+
+        NotificationRuleSet rules({rule("foo/bar", "Default"), byType});
+        // A matching "Default" rule does not stop the scan
+        QCOMPARE(rules.match(make("foo/bar", "PullRequest")), 1);
+        QCOMPARE(rules.match(make("foo/bar", "Issue")), -1);
+    }
+
+    void testCountsEvaluationsAndDecisions() {
+        NotificationRuleSet rules({rule("foo/bar", "Mute"), rule("", "AlwaysSummarize", "mention")});
+        rules.match(make("foo/bar"));
+        rules.match(make("foo/bar", "Issue", "mention"));
+
+        // Both rules were checked twice, but the earlier rule decided both times
+        QCOMPARE(rules.statsAt(0).evaluations, quint64(2));
+        QCOMPARE(rules.statsAt(0).matches, quint64(2));
+        QVERIFY(rules.statsAt(0).lastMatchSecs > 0);
+        QCOMPARE(rules.statsAt(1).evaluations, quint64(2));
+        QCOMPARE(rules.statsAt(1).matches, quint64(0));
+
+        QHash<QString, RuleStats> drained;
+        QVERIFY(rules.drainStats(drained));
+        QCOMPARE(drained.value(NotificationRuleEngine::ruleKey(rule("foo/bar", "Mute"))).matches, quint64(2));
+        QCOMPARE(rules.statsAt(0).evaluations, quint64(0));
+        QVERIFY(!rules.drainStats(drained));
+    }
+
+    void testManyRepoRules() {
+        QList<NotificationRule> list;
+        for (int i = 0; i < 2000; ++i) {
+            list.append(rule(QString("owner%1/repo").arg(i), "Mute"));
+        }
+        list.append(rule("", "AlwaysSummarize"));
+
+        NotificationRuleSet rules(list);
+        QCOMPARE(rules.match(make("owner1234/repo")), 1234);
+        QCOMPARE(rules.match(make("owner1234/other")), 2000);
+    }
+
+    void testSimulationCounts() {
+        NotificationRuleSet rules({rule("foo/bar", "Mute"), rule("", "AlwaysIndividual", "mention"),
+                                   rule("foo/*", "NeverIndividual"), rule("docs/*", "AlwaysSummarize"),
+                                   rule("other/*", "Default")});
+
+        QList<Notification> list = {make("foo/bar", "Issue", "mention"), make("foo/bar"),
+                                    make("baz/qux", "Issue", "mention"), make("foo/baz"),
+                                    make("docs/site"), make("other/thing"), make("unknown/repo")};
+        RuleSimulation result = rules.simulate(list);
+
+        QCOMPARE(result.decisions, QList<int>({0, 0, 1, 2, 3, -1, -1}));
+        QCOMPARE(result.muted, 2);
+        QCOMPARE(result.individual, 1);
+        QCOMPARE(result.summarized, 2);
+        QCOMPARE(result.unmatched, 2);
+        QCOMPARE(rules.statsAt(0).matches, quint64(2));
+    }
+};
+
+QTEST_MAIN(TestNotificationRuleEngine)
+#include "TestNotificationRuleEngine.moc"
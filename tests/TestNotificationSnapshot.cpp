@@ -0,0 +1,76 @@
+#include <QFile>
+#include <QJsonArray>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "../src/NotificationSnapshot.h"
+
+class TestNotificationSnapshot : public QObject {
+    Q_OBJECT
+   private:
+    static Notification make(const QString& id, const QString& type) {
+        Notification n;
+        n.id = id;
+        n.title = QString("Title %1").arg(id);
+        n.type = type;
+        n.repository = "foo/bar";
+        n.url = "https://api.github.com/repos/foo/bar/pulls/" + id;
+        n.htmlUrl = "https://github.com/foo/bar/pull/" + id;
+        n.updatedAt = "2024-01-01T00:00:00Z";
+        n.reason = "review_requested";
+        n.unread = true;
+        n.rawJson = QJsonObject{{"id", id}, {"subject", QJsonObject{{"type", type}}}, {"nested", QJsonArray{1, "two"}}};
+        return n;
+    }
+
+   private slots:
+    void testRoundTrip() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("notifications.snapshot");
+
+        NotificationSnapshot snapshot;
+        snapshot.savedAt = QDateTime::fromSecsSinceEpoch(1700000000);
+        snapshot.lastModified = "Tue, 14 Nov 2023 22:13:20 GMT";
+        snapshot.nextPageUrl = "https://api.github.com/notifications?page=2";
+        Notification pr = make("1", "PullRequest");
+        pr.groupedNotifications.append(make("2", "CheckSuite"));
+        Notification issue = make("3", "Issue");
+        issue.unread = false;
+        issue.lastReadAt = "2024-01-02T00:00:00Z";
+        snapshot.notifications = {pr, issue};
+        QVERIFY(snapshot.save(path));
+
+        NotificationSnapshot loaded = NotificationSnapshot::load(path);
+        QCOMPARE(loaded.savedAt, snapshot.savedAt);
+        QCOMPARE(loaded.lastModified, snapshot.lastModified);
+        QCOMPARE(loaded.nextPageUrl, snapshot.nextPageUrl);
+        QCOMPARE(loaded.notifications.size(), 2);
+        QCOMPARE(loaded.notifications[0].toJson(), pr.toJson());
+        QCOMPARE(loaded.notifications[1].toJson(), issue.toJson());
+        QCOMPARE(loaded.notifications[0].groupedNotifications.size(), 1);
+    }
+
+    void testMissingOrCorruptFileIsEmpty() {
+        QTemporaryDir dir;
+        QString path = dir.filePath("notifications.snapshot");
+        QVERIFY(NotificationSnapshot::load(path).isEmpty());
+
+        NotificationSnapshot snapshot;
+        snapshot.notifications = {make("1", "Issue"), make("2", "Issue")};
+        QVERIFY(snapshot.save(path));
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() - 10));
+        file.close();
+        QVERIFY(NotificationSnapshot::load(path).isEmpty());
+
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("[{\"id\":\"1\"}]");
+        file.close();
+        QVERIFY(NotificationSnapshot::load(path).isEmpty());
+    }
+};
+
+QTEST_MAIN(TestNotificationSnapshot)
+#include "TestNotificationSnapshot.moc"
@@ -0,0 +1,77 @@
+#include <QtTest>
+
+#include "../src/NotificationSorter.h"
+
+class TestNotificationSorter : public QObject {
+    Q_OBJECT
+   private:
+    static Notification make(const QString& id, const QString& repo, const QString& reason, const QString& updatedAt) {
+        Notification n;
+        n.id = id;
+        n.repository = repo;
+        n.reason = reason;
+        n.title = QString("Title %1").arg(id);
+        n.updatedAt = updatedAt;
+        return n;
+    }
+
+    static QStringList ids(const QList<Notification>& notifications) {
+        QStringList result;
+        for (const Notification& n : notifications) {
+            result << n.id;
+        }
+        return result;
+    }
+
+   private slots:
+    void testParseCriteria() {
+        QList<NotificationSorter::SortKey> keys =
+            NotificationSorter::parseCriteria(" Repository, -updated ,+reason,bogus,,lastread");
+        QCOMPARE(keys.size(), 4);
+        QCOMPARE(keys.at(0).field, NotificationSorter::Repository);
+        QCOMPARE(keys.at(0).order, Qt::AscendingOrder);
+        QCOMPARE(keys.at(1).field, NotificationSorter::Updated);
+        QCOMPARE(keys.at(1).order, Qt::DescendingOrder);
+        QCOMPARE(keys.at(2).field, NotificationSorter::Reason);
+        QCOMPARE(keys.at(2).order, Qt::AscendingOrder);
+        QCOMPARE(keys.at(3).field, NotificationSorter::LastRead);
+
+        QCOMPARE(NotificationSorter::criteriaToString(keys), QString("repository,-updated,reason,lastread"));
+        QVERIFY(NotificationSorter::parseCriteria("nothing,known").isEmpty());
+    }
+
+    void testMultiKeyOrder() {
+        QList<Notification> list = {make("1", "b/repo", "mention", "2024-01-01T00:00:00Z"),
+                                    make("2", "a/repo", "subscribed", "2024-01-03T00:00:00Z"),
+                                    make("3", "a/repo", "mention", "2024-01-02T00:00:00Z"),
+                                    make("4", "a/repo", "mention", "2024-01-04T00:00:00Z"),
+                                    make("5", "b/repo", "mention", "2024-01-05T00:00:00Z")};
+
+        NotificationSorter sorter;
+        sorter.setCriteria(NotificationSorter::parseCriteria("repository,reason,-updated"));
+        sorter.sort(list);
+
+        // Ties on repository fall back to reason, then to the newest update
+        QCOMPARE(ids(list), QStringList({"4", "3", "2", "5", "1"}));
+    }
+
+    void testStableAndResortAfterChange() {
+        QList<Notification> list = {make("1", "a/repo", "mention", "2024-01-01T00:00:00Z"),
+                                    make("2", "a/repo", "mention", "2024-01-01T00:00:00Z"),
+                                    make("3", "a/repo", "mention", "2024-01-01T00:00:00Z")};
+
+        NotificationSorter sorter;
+        sorter.setCriteria(NotificationSorter::parseCriteria("-updated"));
+        sorter.sort(list);
+        // Full ties keep their API order
+        QCOMPARE(ids(list), QStringList({"1", "2", "3"}));
+
+        // Cached keys are refreshed when the notification changes
+        list[2].updatedAt = "2024-02-01T00:00:00Z";
+        sorter.sort(list);
+        QCOMPARE(ids(list), QStringList({"3", "1", "2"}));
+    }
+};
+
+QTEST_MAIN(TestNotificationSorter)
+#include "TestNotificationSorter.moc"
@@ -0,0 +1,72 @@
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "../src/NotificationStore.h"
+
+class TestNotificationStore : public QObject {
+    Q_OBJECT
+   private:
+    static Notification make(const QString& id, const QString& repo, const QString& reason, bool unread) {
+        Notification n;
+        n.id = id;
+        n.title = QString("Title %1").arg(id);
+        n.repository = repo;
+        n.reason = reason;
+        n.unread = unread;
+        return n;
+    }
+
+   private slots:
+    void testCountersTrackInsertUpdateRemove() {
+        NotificationStore store;
+        QSignalSpy countsSpy(&store, &NotificationStore::countsChanged);
+
+        store.setNotifications({make("1", "foo/bar", "mention", true), make("2", "foo/bar", "subscribed", false),
+                                make("3", "foo/baz", "mention", true)});
+
+        QCOMPARE(store.totalCount(), 3);
+        QCOMPARE(store.unreadCount(), 2);
+        QCOMPARE(store.unreadCountForRepo("foo/bar"), 1);
+        QCOMPARE(store.unreadCountForReason("mention"), 2);
+        QCOMPARE(store.repositories(), QStringList({"foo/bar", "foo/baz"}));
+        QCOMPARE(countsSpy.count(), 1);
+
+        store.setUnread("1", false);
+        QCOMPARE(store.unreadCount(), 1);
+        QCOMPARE(store.unreadCountForRepo("foo/bar"), 0);
+        QCOMPARE(store.unreadCountForReason("mention"), 1);
+
+        store.removeNotification("2");
+        QCOMPARE(store.totalCount(), 2);
+        QVERIFY(!store.contains("2"));
+        QCOMPARE(store.find("3")->repository, QString("foo/baz"));
+    }
+
+    void testAppendUpsertsById() {
+        NotificationStore store;
+        store.setNotifications({make("1", "foo/bar", "mention", true)});
+        store.appendNotifications({make("1", "foo/bar", "mention", false), make("2", "foo/qux", "author", true)});
+
+        QCOMPARE(store.totalCount(), 2);
+        QCOMPARE(store.unreadCount(), 1);
+        QCOMPARE(store.unreadCountForReason("mention"), 0);
+        QCOMPARE(store.unreadNotifications(5).first().id, QString("2"));
+    }
+
+    void testRepositoriesChangedOnlyWhenSetChanges() {
+        NotificationStore store;
+        store.setNotifications({make("1", "foo/bar", "mention", true)});
+
+        QSignalSpy repoSpy(&store, &NotificationStore::repositoriesChanged);
+        store.appendNotifications({make("2", "foo/bar", "mention", true)});
+        QCOMPARE(repoSpy.count(), 0);
+
+        store.removeNotification("1");
+        store.removeNotification("2");
+        QCOMPARE(repoSpy.count(), 1);
+        QVERIFY(store.repositories().isEmpty());
+    }
+};
+
+QTEST_MAIN(TestNotificationStore)
+#include "TestNotificationStore.moc"
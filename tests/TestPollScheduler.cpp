@@ -0,0 +1,81 @@
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "../src/PollScheduler.h"
+
+class TestPollScheduler : public QObject {
+    Q_OBJECT
+   private slots:
+    void testIdleBackoff() {
+        PollScheduler scheduler;
+        scheduler.setBaseInterval(60000);
+        QCOMPARE(scheduler.intervalMs(), 60000);
+
+        scheduler.reportResult(PollScheduler::Unchanged);
+        QCOMPARE(scheduler.intervalMs(), 60000);
+        scheduler.reportResult(PollScheduler::Unchanged);
+        QCOMPARE(scheduler.intervalMs(), 120000);
+        scheduler.reportResult(PollScheduler::Unchanged);
+        scheduler.reportResult(PollScheduler::Unchanged);
+        scheduler.reportResult(PollScheduler::Unchanged);
+        QCOMPARE(scheduler.intervalMs(), 240000);
+
+        // New activity shortens the interval again for a while
+        scheduler.reportResult(PollScheduler::Changed);
+        QVERIFY(scheduler.isBoosted());
+        QCOMPARE(scheduler.intervalMs(), 30000);
+    }
+
+    void testErrorBackoffIsCapped() {
+        PollScheduler scheduler;
+        scheduler.setBaseInterval(5 * 60000);
+        scheduler.reportResult(PollScheduler::Failed);
+        QCOMPARE(scheduler.intervalMs(), 10 * 60000);
+        for (int i = 0; i < 10; ++i) scheduler.reportResult(PollScheduler::Failed);
+        QCOMPARE(scheduler.intervalMs(), 60 * 60000);
+
+        scheduler.reportResult(PollScheduler::Unchanged);
+        QCOMPARE(scheduler.intervalMs(), 5 * 60000);
+    }
+
+    void testFloorsWin() {
+        PollScheduler scheduler;
+        scheduler.setBaseInterval(60000);
+        scheduler.noteActivity();
+        scheduler.setServerMinimum(60);
+        QCOMPARE(scheduler.intervalMs(), 60000);
+
+        // Nothing left until the reset: wait for it
+        scheduler.setRateLimit(0, QDateTime::currentSecsSinceEpoch() + 600);
+        QVERIFY(scheduler.intervalMs() >= 599000);
+
+        scheduler.setRateLimit(5000, QDateTime::currentSecsSinceEpoch() + 600);
+        QCOMPARE(scheduler.intervalMs(), 60000);
+    }
+
+    void testPauseAndResume() {
+        PollScheduler scheduler;
+        scheduler.setBaseInterval(60000);
+        QSignalSpy polls(&scheduler, &PollScheduler::pollRequested);
+
+        scheduler.start();
+        QVERIFY(scheduler.remainingMs() > 0);
+
+        scheduler.setPaused(PollScheduler::Offline, true);
+        scheduler.setPaused(PollScheduler::SessionLocked, true);
+        QCOMPARE(scheduler.remainingMs(), qint64(-1));
+        QVERIFY(!scheduler.nextPollTime().isValid());
+
+        scheduler.setPaused(PollScheduler::Offline, false);
+        QVERIFY(scheduler.isPaused());
+        QCOMPARE(scheduler.remainingMs(), qint64(-1));
+
+        // The last reason going away polls straight away
+        scheduler.setPaused(PollScheduler::SessionLocked, false);
+        QTRY_COMPARE(polls.count(), 1);
+        QVERIFY(scheduler.remainingMs() > 0);
+    }
+};
+
+QTEST_MAIN(TestPollScheduler)
+#include "TestPollScheduler.moc"
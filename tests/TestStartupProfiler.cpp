@@ -0,0 +1,53 @@
+#include <QFile>
+#include <QStandardPaths>
+#include <QtTest>
+
+#include "../src/StartupProfiler.h"
+
+class TestStartupProfiler : public QObject {
+    Q_OBJECT
+   private slots:
+    void initTestCase() {
+        QStandardPaths::setTestModeEnabled(true);
+        QCoreApplication::setOrganizationName("kgithub-notify-tests");
+        QCoreApplication::setApplicationName("TestStartupProfiler");
+        QFile::remove(StartupProfiler::reportPath());
+    }
+
+    void cleanupTestCase() { QFile::remove(StartupProfiler::reportPath()); }
+
+    void testNoReportBeforeFirstStart() { QVERIFY(StartupProfiler::lastReport().isEmpty()); }
+
+    void testPhasesAreReportedInOrder() {
+        StartupProfiler::start();
+        StartupProfiler::mark("first");
+        StartupProfiler::mark("second");
+
+        QStringList report = StartupProfiler::report();
+        QCOMPARE(report.size(), 4);  // Header, two phases, total
+        QVERIFY(report.at(1).trimmed().startsWith("first"));
+        QVERIFY(report.at(2).trimmed().startsWith("second"));
+        QVERIFY(report.last().trimmed().startsWith("total"));
+        QVERIFY(!StartupProfiler::isFinished());
+    }
+
+    void testFinishWritesReportOnce() {
+        StartupProfiler::start();
+        StartupProfiler::mark("window");
+        StartupProfiler::finish();
+        QVERIFY(StartupProfiler::isFinished());
+
+        QStringList saved = StartupProfiler::lastReport();
+        QCOMPARE(saved.size(), 4);  // Header, window, event loop, total
+        QVERIFY(saved.at(2).trimmed().startsWith("event loop"));
+
+        // Marks after the event loop is reached belong to no phase
+        StartupProfiler::mark("late");
+        StartupProfiler::finish();
+        QCOMPARE(StartupProfiler::report().size(), 4);
+        QCOMPARE(StartupProfiler::lastReport(), saved);
+    }
+};
+
+QTEST_MAIN(TestStartupProfiler)
+#include "TestStartupProfiler.moc"
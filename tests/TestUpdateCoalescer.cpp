@@ -0,0 +1,45 @@
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "../src/UpdateCoalescer.h"
+
+class TestUpdateCoalescer : public QObject {
+    Q_OBJECT
+   private slots:
+    void testBurstFlushesOnce() {
+        UpdateCoalescer coalescer(20);
+        QSignalSpy spy(&coalescer, &UpdateCoalescer::flush);
+
+        coalescer.schedule();
+        coalescer.schedule();
+        coalescer.schedule();
+        QVERIFY(coalescer.isPending());
+        QCOMPARE(spy.count(), 0);
+
+        QVERIFY(spy.wait(1000));
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.takeFirst().at(0).toInt(), 3);
+        QVERIFY(!coalescer.isPending());
+
+        // Nothing else was scheduled, so the burst produced exactly one flush
+        QTest::qWait(60);
+        QCOMPARE(spy.count(), 0);
+    }
+
+    void testLaterRequestStartsNewWindow() {
+        UpdateCoalescer coalescer(20);
+        QSignalSpy spy(&coalescer, &UpdateCoalescer::flush);
+
+        coalescer.schedule();
+        coalescer.schedule();
+        QVERIFY(spy.wait(1000));
+        QCOMPARE(spy.takeFirst().at(0).toInt(), 2);
+
+        coalescer.schedule();
+        QVERIFY(spy.wait(1000));
+        QCOMPARE(spy.takeFirst().at(0).toInt(), 1);
+    }
+};
+
+QTEST_MAIN(TestUpdateCoalescer)
+#include "TestUpdateCoalescer.moc"